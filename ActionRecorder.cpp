@@ -0,0 +1,115 @@
+#include "ActionRecorder.h"
+
+#include <cassert>
+#include <iostream>
+
+ActionRecorder::~ActionRecorder()
+{
+	// Left without an end record, so a replay just runs until its last action
+	if (m_file.is_open()) { m_file.close(); }
+}
+
+bool ActionRecorder::start(const std::string& path, const std::string& levelPath, int tickRate)
+{
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open())
+	{
+		std::cerr << "Could not open " << path << " to record actions to" << std::endl;
+		return false;
+	}
+
+	m_names.clear();
+	m_types.clear();
+	m_lastTick = 0;
+	m_count = 0;
+
+	m_file.write(MAGIC, sizeof(MAGIC));
+	m_file.put((char)VERSION);
+	writeVarint(m_file, levelPath.size());
+	m_file.write(levelPath.data(), levelPath.size());
+	writeVarint(m_file, (uint64_t)tickRate);
+
+	std::cout << "Recording actions to " << path << "\n";
+	return true;
+}
+
+// Writes str's id shifted up by flagBits with flags in the low bits, followed by str itself the first time it's seen
+void ActionRecorder::writeString(const std::string& str, std::unordered_map<std::string, uint32_t>& table, int flagBits, uint64_t flags)
+{
+	auto it = table.find(str);
+	if (it != table.end())
+	{
+		writeVarint(m_file, (uint64_t)it->second << flagBits | flags);
+		return;
+	}
+
+	uint32_t id = (uint32_t)table.size();
+	table[str] = id;
+	writeVarint(m_file, (uint64_t)id << flagBits | flags);
+	writeVarint(m_file, str.size());
+	m_file.write(str.data(), str.size());
+}
+
+void ActionRecorder::record(size_t tick, const Action& action)
+{
+	if (!m_file.is_open()) { return; }
+	assert(tick >= m_lastTick);
+
+	bool hasPos = action.pos().x != 0 || action.pos().y != 0;
+
+	m_file.put(RECORD_ACTION);
+	writeVarint(m_file, tick - m_lastTick);
+	writeString(action.name(), m_names, 0, 0);
+	writeString(action.type(), m_types, 1, hasPos);
+
+	if (hasPos)
+	{
+		float pos[2] = { action.pos().x, action.pos().y };
+		m_file.write(reinterpret_cast<const char*>(pos), sizeof(pos));
+	}
+
+	m_lastTick = tick;
+	m_count++;
+}
+
+// tick and checksum describe the scene when recording stopped, so a replay can check it ends up the same
+void ActionRecorder::stop(size_t tick, uint64_t checksum)
+{
+	if (!m_file.is_open()) { return; }
+
+	m_file.put(RECORD_END);
+	writeVarint(m_file, tick - m_lastTick);
+	m_file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+	m_file.close();
+
+	std::cout << "Recorded " << m_count << " actions over " << tick << " ticks\n";
+}
+
+bool ActionRecorder::isRecording() const
+{
+	return m_file.is_open();
+}
+
+void ActionRecorder::writeVarint(std::ostream& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out.put((char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	out.put((char)value);
+}
+
+bool ActionRecorder::readVarint(std::istream& in, uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		int byte = in.get();
+		if (byte == EOF) { return false; }
+
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) { return true; }
+	}
+	return false;
+}
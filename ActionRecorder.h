@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Action.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+// Writes every Action a scene receives, with the simulation tick it arrived on, to a compact binary file
+// that ActionReplay can feed back into the scene to play the exact same run again.
+//
+// File layout, integers are LEB128 varints unless noted:
+//		"SREC", u8 version, level path (length + bytes), tick rate
+//		records until the end of the file, each starting with a kind byte:
+//			'A' tick delta, name id, (type id << 1 | has pos), [f32 x, f32 y]
+//			'E' tick delta, u64 state checksum - written when recording stops normally
+// A name or type id equal to the number of strings seen so far is a new string, and its length
+// and bytes follow the id. Gameplay only uses a handful of names so most actions take 4 bytes.
+class ActionRecorder
+{
+	std::ofstream								m_file;
+	std::unordered_map<std::string, uint32_t>	m_names;
+	std::unordered_map<std::string, uint32_t>	m_types;
+	size_t										m_lastTick = 0;
+	size_t										m_count = 0;
+
+	void writeString(const std::string& str, std::unordered_map<std::string, uint32_t>& table, int flagBits, uint64_t flags);
+
+public:
+	static constexpr char MAGIC[4] = { 'S', 'R', 'E', 'C' };
+	static constexpr uint8_t VERSION = 1;
+	static constexpr char RECORD_ACTION = 'A';
+	static constexpr char RECORD_END = 'E';
+
+	ActionRecorder() {}
+	~ActionRecorder();
+
+	ActionRecorder(const ActionRecorder&) = delete;
+	ActionRecorder& operator=(const ActionRecorder&) = delete;
+
+	bool start(const std::string& path, const std::string& levelPath, int tickRate);
+	void record(size_t tick, const Action& action);
+	void stop(size_t tick, uint64_t checksum);
+	bool isRecording() const;
+
+	static void writeVarint(std::ostream& out, uint64_t value);
+	static bool readVarint(std::istream& in, uint64_t& value);
+};
@@ -0,0 +1,176 @@
+#include "ActionReplay.h"
+#include "ActionRecorder.h"
+#include "Scene.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Counterpart of ActionRecorder::writeString
+bool ActionReplay::readString(std::istream& in, std::vector<std::string>& table, int flagBits, std::string& str, uint64_t& flags)
+{
+	uint64_t value = 0;
+	if (!ActionRecorder::readVarint(in, value)) { return false; }
+
+	flags = value & ((1ull << flagBits) - 1);
+	uint64_t id = value >> flagBits;
+
+	if (id < table.size())
+	{
+		str = table[id];
+		return true;
+	}
+	if (id > table.size()) { return false; }
+
+	uint64_t length = 0;
+	if (!ActionRecorder::readVarint(in, length) || length > 1024) { return false; }
+
+	str.resize(length);
+	if (!in.read(&str[0], length)) { return false; }
+
+	table.push_back(str);
+	return true;
+}
+
+bool ActionReplay::loadFromFile(const std::string& path)
+{
+	std::ifstream fin(path, std::ios::binary);
+	if (!fin.is_open())
+	{
+		std::cerr << "Could not open replay: " << path << std::endl;
+		return false;
+	}
+
+	m_actions.clear();
+	m_next = 0;
+	m_hasEnd = false;
+	m_endTick = 0;
+	m_checksum = 0;
+
+	char magic[4] = {};
+	fin.read(magic, sizeof(magic));
+	int version = fin.get();
+	if (!fin || std::memcmp(magic, ActionRecorder::MAGIC, sizeof(magic)) != 0 || version != ActionRecorder::VERSION)
+	{
+		std::cerr << path << " is not a version " << (int)ActionRecorder::VERSION << " action recording" << std::endl;
+		return false;
+	}
+
+	uint64_t length = 0, tickRate = 0;
+	if (!ActionRecorder::readVarint(fin, length) || length > 4096)
+	{
+		std::cerr << path << ": bad level path" << std::endl;
+		return false;
+	}
+	m_levelPath.resize(length);
+	fin.read(&m_levelPath[0], length);
+	if (!fin || !ActionRecorder::readVarint(fin, tickRate))
+	{
+		std::cerr << path << ": truncated header" << std::endl;
+		return false;
+	}
+	m_tickRate = (int)tickRate;
+
+	std::vector<std::string> names, types;
+	size_t tick = 0;
+	int kind;
+	while ((kind = fin.get()) != EOF)
+	{
+		uint64_t delta = 0;
+		if (!ActionRecorder::readVarint(fin, delta)) { break; }
+		tick += delta;
+
+		if (kind == ActionRecorder::RECORD_END)
+		{
+			if (fin.read(reinterpret_cast<char*>(&m_checksum), sizeof(m_checksum)))
+			{
+				m_hasEnd = true;
+				m_endTick = tick;
+			}
+			break;
+		}
+
+		std::string name, type;
+		uint64_t flags = 0, hasPos = 0;
+		if (kind != ActionRecorder::RECORD_ACTION ||
+			!readString(fin, names, 0, name, flags) ||
+			!readString(fin, types, 1, type, hasPos))
+		{
+			break;
+		}
+
+		Vec2 pos;
+		if (hasPos)
+		{
+			float xy[2] = {};
+			if (!fin.read(reinterpret_cast<char*>(xy), sizeof(xy))) { break; }
+			pos = Vec2(xy[0], xy[1]);
+		}
+
+		m_actions.push_back({ tick, Action(name, type, pos) });
+	}
+
+	if (!m_hasEnd)
+	{
+		std::cerr << path << " has no end record, the recording was cut short. Replaying the " << m_actions.size() << " actions read." << std::endl;
+	}
+
+	return true;
+}
+
+// Sends every action recorded on or before tick that hasn't been sent yet
+void ActionReplay::dispatch(size_t tick, Scene& scene)
+{
+	while (m_next < m_actions.size() && m_actions[m_next].tick <= tick)
+	{
+		scene.doAction(m_actions[m_next].action);
+		m_next++;
+	}
+}
+
+void ActionReplay::rewind()
+{
+	m_next = 0;
+}
+
+bool ActionReplay::finished() const
+{
+	return m_next >= m_actions.size();
+}
+
+// Last tick anything happens on, the end record if there is one
+size_t ActionReplay::lastTick() const
+{
+	if (m_hasEnd) { return m_endTick; }
+	return m_actions.empty() ? 0 : m_actions.back().tick;
+}
+
+size_t ActionReplay::size() const
+{
+	return m_actions.size();
+}
+
+const std::string& ActionReplay::levelPath() const
+{
+	return m_levelPath;
+}
+
+int ActionReplay::tickRate() const
+{
+	return m_tickRate;
+}
+
+bool ActionReplay::hasEnd() const
+{
+	return m_hasEnd;
+}
+
+size_t ActionReplay::endTick() const
+{
+	return m_endTick;
+}
+
+uint64_t ActionReplay::checksum() const
+{
+	return m_checksum;
+}
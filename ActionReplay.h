@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Action.h"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+class Scene;
+
+// Reads a file written by ActionRecorder and feeds its actions back into a scene on the ticks they
+// were recorded on. Since the simulation only changes through update() and actions, replaying into
+// a freshly loaded level reproduces the recorded run tick for tick.
+class ActionReplay
+{
+	struct RecordedAction
+	{
+		size_t		tick = 0;
+		Action		action;
+	};
+
+	std::vector<RecordedAction>		m_actions;
+	size_t							m_next = 0;
+	std::string						m_levelPath;
+	int								m_tickRate = 60;
+	bool							m_hasEnd = false;			// Recording was stopped normally
+	size_t							m_endTick = 0;
+	uint64_t						m_checksum = 0;
+
+	bool readString(std::istream& in, std::vector<std::string>& table, int flagBits, std::string& str, uint64_t& flags);
+
+public:
+	ActionReplay() {}
+
+	bool loadFromFile(const std::string& path);
+	void dispatch(size_t tick, Scene& scene);
+	void rewind();
+
+	bool finished() const;
+	size_t lastTick() const;
+	size_t size() const;
+	const std::string& levelPath() const;
+	int tickRate() const;
+	bool hasEnd() const;
+	size_t endTick() const;
+	uint64_t checksum() const;
+};
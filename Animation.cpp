@@ -1,10 +1,12 @@
 #include "Animation.h"
-#include <cctype>
 #include <string>
 #include <cmath>
-#include <regex>
 
-Animation::Animation() : m_sprite(getDummyTexture()) {};
+Animation::Animation() :
+	Animation("NONE", getDummyTexture())
+{
+
+}
 
 Animation::Animation(const std::string& name, const sf::Texture& t) :
 	Animation(name, t, 1, 0)
@@ -13,15 +15,29 @@ Animation::Animation(const std::string& name, const sf::Texture& t) :
 }
 
 Animation::Animation(const std::string& name, const sf::Texture& t, size_t frameCount, size_t speed) :
-	m_name(name),
+	Animation(name, t, sf::IntRect({ 0, 0 }, { (int)t.getSize().x, (int)t.getSize().y }), frameCount, speed)
+{
+
+}
+
+// The frames are laid out left to right across region, which is the animation strip's place in its texture
+Animation::Animation(const std::string& name, const sf::Texture& t, const sf::IntRect& region, size_t frameCount, size_t speed) :
+	m_texture(&t),
 	m_sprite(t),
-	m_frameCount(frameCount),
-	m_currentFrame(0),
-	m_speed(speed)
+	m_speed(speed),
+	m_name(name)
 {
-	m_size = Vec2((float)t.getSize().x / frameCount, (float)t.getSize().y);
+	if (frameCount == 0) { frameCount = 1; }
+
+	m_size = Vec2((float)region.size.x / frameCount, (float)region.size.y);
+	m_frames.reserve(frameCount);
+	for (size_t i = 0; i < frameCount; ++i)
+	{
+		m_frames.push_back(sf::IntRect({ region.position.x + (int)i * (int)m_size.x, region.position.y }, { (int)m_size.x, (int)m_size.y }));
+	}
+
 	m_sprite.setOrigin({ m_size.x / 2.0f, m_size.y / 2.0f });
-	m_sprite.setTextureRect(sf::IntRect({ (int)std::floor(m_currentFrame) * (int)m_size.x, 0 }, { (int)m_size.x, (int)m_size.y } ));
+	m_sprite.setTextureRect(m_frames[0]);
 }
 
 sf::Texture& Animation::getDummyTexture() 
@@ -30,23 +46,40 @@ sf::Texture& Animation::getDummyTexture()
 	return dummy;
 }
 
-// Updates the animation to show the next frame, depending on its speed
+// Clip handed out to entities that haven't been given one
+const Animation& Animation::getEmpty()
+{
+	static const Animation empty;
+	return empty;
+}
+
+// Frame to show after the clip has been playing for elapsedFrames game frames.
 // Animation loops when it reaches the end
-void Animation::update()
+const sf::IntRect& Animation::getFrameRect(size_t elapsedFrames) const
 {
 	// If the speed is zero then there is only one animation frame and no other frames to switch to.
-	if (m_speed != 0)
-	{
-		m_currentFrame++;
-		size_t animFrame = (m_currentFrame / m_speed) % m_frameCount;
+	if (m_speed == 0) { return m_frames[0]; }
+	return m_frames[(elapsedFrames / m_speed) % m_frames.size()];
+}
 
-		m_sprite.setTextureRect(sf::IntRect({ (int)std::floor(animFrame) * (int)m_size.x, 0 }, { (int)m_size.x, (int)m_size.y }));
-	}
+size_t Animation::getFrameCount() const
+{
+	return m_frames.size();
+}
+
+size_t Animation::getSpeed() const
+{
+	return m_speed;
+}
+
+const sf::Texture& Animation::getTexture() const
+{
+	return *m_texture;
 }
 
 const size_t Animation::getDuration() const
 {
-	return m_speed * m_frameCount;
+	return m_speed * m_frames.size();
 }
 
 const Vec2& Animation::getSize() const
@@ -59,61 +92,23 @@ const std::string& Animation::getName() const
 	return m_name;
 }
 
-sf::Sprite& Animation::getSprite()
-{
-	return m_sprite;
-}
-
 const sf::Sprite& Animation::getSprite() const
 {
 	return m_sprite;
 }
 
-std::string Animation::getType() const
+AnimationType Animation::getType() const
 {
-	std::smatch matches;
-	std::regex pattern("Run|Jump|Crouch|Idle|Dead|Rush|Shoot");
-
-	if (std::regex_search(m_name, matches, pattern))
-	{
-		std::string match = matches[0];
-		for (char& c : match)
-		{
-			c = std::toupper(static_cast<unsigned char>(c));
-		}
-
-		return match;
-	}
-	else
-	{
-		return "NO_MATCH";
-	}
-
-	return "";
+	return m_type;
 }
 
-std::string Animation::getEntityName()
+AnimationEntityId Animation::getEntityId() const
 {
-	std::smatch matches;
-	std::regex pattern("^(.*?)(?=Run|Jump|Crouch|Idle|Dead|Rush|Shoot)");
-
-	if (std::regex_search(m_name, matches, pattern))
-	{
-		return matches[0];
-	}
-	else
-	{
-		return "NO_MATCH";
-	}
-
-	return "";
+	return m_entityId;
 }
 
-bool Animation::hasEnded() const
+void Animation::setMetadata(AnimationEntityId entityId, AnimationType type)
 {
-	if (m_currentFrame == m_frameCount * m_speed)
-	{
-		return true;
-	}
-	return false;
-}
\ No newline at end of file
+	m_entityId = entityId;
+	m_type = type;
+}
@@ -3,32 +3,60 @@
 #include "Vec2.h"
 
 #include <vector>
+#include <cstdint>
 #include <SFML/Graphics.hpp>
 
+// The type an animation's name ends in, e.g. "EnemyCrawlerRush" is entity "EnemyCrawler" with type Rush.
+// Parsed once by Assets::addAnimation so systems can compare and look up animations without touching the name.
+enum class AnimationType : uint8_t
+{
+	None,
+	Run,
+	Jump,
+	Crouch,
+	Idle,
+	Dead,
+	Rush,
+	Shoot,
+	Count
+};
+
+// Interned id of the entity part of an animation's name, handed out by Assets
+typedef uint16_t AnimationEntityId;
+
+// An immutable animation clip shared by every entity playing it. Assets owns the clips and entities
+// only store a pointer to one plus how long they've been playing it (see CAnimation).
 class Animation
 {
-	sf::Texture		m_texture;
-	sf::Sprite		m_sprite;
-	size_t			m_frameCount = 1;		// Total number of frames of animation
-	size_t			m_currentFrame = 0;		// Current frame of animation being played
-	size_t			m_speed = 0;			// Speed to play the animation at
-	Vec2			m_size = { 1, 1 };		// Size of the animation frame
-	std::string		m_name = "NONE";
+	const sf::Texture*			m_texture = nullptr;
+	sf::Sprite					m_sprite;				// Origin centered, showing the first frame
+	std::vector<sf::IntRect>	m_frames;				// Texture rect of each frame
+	size_t						m_speed = 0;			// Game frames each animation frame is shown for
+	Vec2						m_size = { 1, 1 };		// Size of the animation frame
+	std::string					m_name = "NONE";
+	AnimationEntityId			m_entityId = NO_ENTITY;
+	AnimationType				m_type = AnimationType::None;
 
 public:
+	static constexpr AnimationEntityId NO_ENTITY = UINT16_MAX;
+
 	Animation();
 	Animation(const std::string& name, const sf::Texture& t);
 	Animation(const std::string& name, const sf::Texture& t, size_t frameCount, size_t speed);
+	Animation(const std::string& name, const sf::Texture& t, const sf::IntRect& region, size_t frameCount, size_t speed);
 
-	void update();
-	bool hasEnded() const;
 	const std::string& getName() const;
-	std::string getType() const;
-	std::string getEntityName();
+	AnimationType getType() const;
+	AnimationEntityId getEntityId() const;
+	void setMetadata(AnimationEntityId entityId, AnimationType type);
 	const Vec2& getSize() const;
-	sf::Sprite& getSprite();
+	const sf::Texture& getTexture() const;			// Atlas page the frames live on
 	const sf::Sprite& getSprite() const;
+	const sf::IntRect& getFrameRect(size_t elapsedFrames) const;
+	size_t getFrameCount() const;
+	size_t getSpeed() const;
 	const size_t getDuration() const;
 
 	static sf::Texture& getDummyTexture();
+	static const Animation& getEmpty();
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "AssetLoader.h"
+
+#include <algorithm>
+
+AssetLoader::AssetLoader(size_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		size_t cores = std::thread::hardware_concurrency();
+		threadCount = std::max<size_t>(1, cores > 1 ? cores - 1 : 1);
+	}
+
+	m_workers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		m_workers.emplace_back(&AssetLoader::workerLoop, this);
+	}
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_stopping = true;
+		m_jobs.clear();
+	}
+	m_wake.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void AssetLoader::workerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+			if (m_stopping) { return; }
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		job();
+
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_finished++;
+		}
+		m_idle.notify_all();
+	}
+}
+
+void AssetLoader::add(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_jobs.push_back(std::move(job));
+		m_queued++;
+	}
+	m_wake.notify_one();
+}
+
+// Blocks until every job added so far has finished
+void AssetLoader::wait()
+{
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_idle.wait(lock, [this] { return m_finished == m_queued; });
+}
+
+size_t AssetLoader::queued() const
+{
+	return m_queued;
+}
+
+size_t AssetLoader::finished() const
+{
+	return m_finished;
+}
+
+bool AssetLoader::done() const
+{
+	return m_finished == m_queued;
+}
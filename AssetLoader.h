@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small worker pool Assets uses to decode files off the main thread. Jobs must only do CPU work
+// (decoding into sf::Image / sf::SoundBuffer) - anything touching the GPU or shared Assets state
+// is left for the main thread once the jobs are done.
+class AssetLoader
+{
+	std::vector<std::thread>				m_workers;
+	std::deque<std::function<void()>>		m_jobs;
+	std::mutex								m_lock;
+	std::condition_variable					m_wake;				// Workers wait on it for jobs
+	std::condition_variable					m_idle;				// wait() waits on it for the last job
+	size_t									m_queued = 0;
+	std::atomic<size_t>						m_finished = 0;
+	bool									m_stopping = false;
+
+	void workerLoop();
+
+public:
+	AssetLoader(size_t threadCount = 0);				// 0 uses one thread per core, less the main thread
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	void add(std::function<void()> job);
+	void wait();
+
+	size_t queued() const;
+	size_t finished() const;
+	bool done() const;
+};
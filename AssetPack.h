@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of the asset pack written by tools/AssetPacker and read by Assets::loadFromPack.
+//
+// The file is a header, a table of contents with one PackSection per section, then the sections.
+// Every record is a fixed size little endian struct, so loading is a few bounds checks and memcpys
+// out of the mapped file - there is no text to parse and no images to decode or slice.
+//
+//		Strings		Every name and path, packed end to end and referred to by PackString
+//		Pages		One PackPage per atlas page, pointing into Pixels
+//		Pixels		Atlas pages as raw RGBA, already packed and padded
+//		Regions		One PackRegion per texture or tile: where it is in the atlas
+//		Animations	One PackAnimation per Animation record in assets.txt
+//		Files		Fonts and sounds, copied in whole, and music paths (music is streamed from disk)
+//		Data		The bytes the Files section points into
+
+static constexpr char		ASSET_PACK_MAGIC[4] = { 'S', 'P', 'A', 'K' };
+static constexpr uint32_t	ASSET_PACK_VERSION = 2;
+
+enum class PackSectionId : uint32_t
+{
+	Strings,
+	Pages,
+	Pixels,
+	Regions,
+	Animations,
+	Files,
+	Data,
+	Count
+};
+
+enum class PackFileKind : uint32_t
+{
+	Font,
+	Sound,
+	Music
+};
+
+struct PackHeader
+{
+	char		magic[4];
+	uint32_t	version;
+	uint32_t	sectionCount;
+	uint32_t	reserved;
+};
+
+// Offsets are from the start of the file, counts are records in the section
+struct PackSection
+{
+	uint32_t	id;
+	uint32_t	count;
+	uint64_t	offset;
+	uint64_t	size;
+};
+
+// Offset into the Strings section
+struct PackString
+{
+	uint32_t	offset;
+	uint32_t	length;
+};
+
+struct PackPage
+{
+	uint32_t	width;
+	uint32_t	height;
+	uint32_t	smooth;					// 1 if the page is drawn with filtering
+	uint32_t	reserved;
+	uint64_t	pixelOffset;			// Into the Pixels section, width * height * 4 bytes
+};
+
+struct PackRegion
+{
+	PackString	name;
+	uint32_t	page;
+	int32_t		x, y, width, height;
+};
+
+struct PackAnimation
+{
+	PackString	name;
+	PackString	textureName;
+	uint32_t	frameCount;
+	uint32_t	speed;
+};
+
+struct PackFile
+{
+	PackString	name;
+	uint32_t	kind;					// PackFileKind
+	uint32_t	reserved;
+	uint64_t	dataOffset;				// Into the Data section
+	uint64_t	dataSize;
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout changed");
+static_assert(sizeof(PackSection) == 24, "PackSection layout changed");
+static_assert(sizeof(PackPage) == 24, "PackPage layout changed");
+static_assert(sizeof(PackRegion) == 28, "PackRegion layout changed");
+static_assert(sizeof(PackAnimation) == 24, "PackAnimation layout changed");
+static_assert(sizeof(PackFile) == 32, "PackFile layout changed");
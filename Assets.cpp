@@ -1,9 +1,19 @@
 #include "Assets.h"
+#include "AssetPack.h"
 #include "MemoryMapping.h"
+#include "Tokenizer.h"
 #include <cassert>
-#include <fstream>
-#include <sstream>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define ASSETS_SSE2 1
+#else
+	#define ASSETS_SSE2 0
+#endif
 
 
 Assets::Assets()
@@ -11,159 +21,594 @@ Assets::Assets()
 
 }
 
+// assets.txt has one asset per line, the record type followed by its fields:
+//		Texture <name> <image path>
+//		Animation <name> <texture name> <frame count> <game frames per animation frame>
+//		Tilesheet <name> <image path> <tile name>...		(one name per non-empty tile, column by column)
+//		Font <name> <font path>
+//		Sound <name> <sound path>
+//		Music <name> <music path>							(streamed when played, only the path is kept)
+// Lines starting with # are comments. A malformed line is reported with its line and column and skipped,
+// the rest of the file still loads.
+//
+// Blocks until everything is loaded. The game uses beginLoading / updateLoading instead so it can draw
+// a loading screen in the meantime.
 bool Assets::loadFromFile(const std::string& path)
 {
+	if (!beginLoading(path)) { return false; }
+
+	if (m_loader) { m_loader->wait(); }
+	updateLoading();
+	return loadSucceeded();
+}
+
+// Reads assets.txt and queues every image and sound on the loader's worker threads, which decode them
+// while the caller carries on. Fonts are small and needed by the loading screen, so they load right away.
+// A .pack file made by the asset packer has nothing left to decode and is loaded before this returns.
+bool Assets::beginLoading(const std::string& path)
+{
+	assert(!m_loader && "Assets are already loading");
+
+	const std::string packExtension = ".pack";
+	if (path.size() >= packExtension.size() && path.compare(path.size() - packExtension.size(), packExtension.size(), packExtension) == 0)
+	{
+		return loadFromPack(path);
+	}
+
 	MemoryMapping mm(path);
-	char* fileData = mm.getData();
-	std::stringstream fileContentStream(fileData);
-	std::string line, token, identifier;
-	std::vector<std::string> tempVector;
+	if (!mm.isOpen()) { return false; }
 
-	std::stringstream lineStream;
+	m_loader = std::make_unique<AssetLoader>();
+	m_loadingPath = path;
+	m_loadErrors = 0;
 
-	try 
+	// Tokens are views into the mapped file, only copied into strings where an asset keeps its name
+	Tokenizer tokenizer(mm.view());
+	auto reportError = [&](size_t line, size_t column, const std::string& message)
+	{
+		std::cerr << path << ":" << line << ":" << column << ": " << message << std::endl;
+		m_loadErrors++;
+	};
+
+	enum class Record { Texture, Animation, Tilesheet, Font, Sound, Music };
+	struct RecordFormat
+	{
+		std::string_view	type;
+		Record				record;
+		size_t				fieldCount;			// Tilesheets have tile names after these
+		const char*			usage;
+	};
+	static const RecordFormat formats[] =
 	{
-		while (getline(fileContentStream, line))
+		{ "Texture",	Record::Texture,	2, "Texture <name> <image path>" },
+		{ "Animation",	Record::Animation,	4, "Animation <name> <texture name> <frame count> <speed>" },
+		{ "Tilesheet",	Record::Tilesheet,	2, "Tilesheet <name> <image path> <tile names...>" },
+		{ "Font",		Record::Font,		2, "Font <name> <font path>" },
+		{ "Sound",		Record::Sound,		2, "Sound <name> <sound path>" },
+		{ "Music",		Record::Music,		2, "Music <name> <music path>" }
+	};
+
+	std::string_view type, fields[4];
+	size_t fieldColumns[4] = {};
+	std::vector<std::string_view> tileNames;
+
+	while (!tokenizer.atEnd())
+	{
+		tokenizer.nextOnLine(type);
+		size_t line = tokenizer.line(), column = tokenizer.column();
+
+		if (type[0] == '#')
 		{
-			// proccess each line
-			lineStream.str(line);
-			while (lineStream >> token)
-			{
-				if (token == "Tilesheet" ||
-					token == "Texture" ||
-					token == "Animation" ||
-					token == "Font")
-				{
-					identifier = token;
-					continue;
-				}
-				tempVector.push_back(token);
-			}
+			tokenizer.skipLine();
+			continue;
+		}
 
-			// clear the stream to be able to reuse it
-			lineStream.clear();
+		const RecordFormat* format = nullptr;
+		for (auto& f : formats)
+		{
+			if (f.type == type) { format = &f; break; }
+		}
+		if (!format)
+		{
+			reportError(line, column, "unknown asset type '" + std::string(type) + "'");
+			tokenizer.skipLine();
+			continue;
+		}
 
-			// Since the asset.txt file has a specification for how it it structured, the order of the data stays the same.
-			// This means we can specify the index and always get the correct data. E.g. The identifier for what kind of
-			// assets that line represents is always the first string.
+		size_t fieldCount = 0;
+		while (fieldCount < format->fieldCount && tokenizer.nextOnLine(fields[fieldCount]))
+		{
+			fieldColumns[fieldCount++] = tokenizer.column();
+		}
+		if (fieldCount < format->fieldCount)
+		{
+			reportError(line, column, "too few fields, expected " + std::string(format->usage));
+			tokenizer.skipLine();
+			continue;
+		}
 
-			if (identifier == "Tilesheet") { processTilesheet(tempVector[0], tempVector[1], tempVector); }
-			else if (identifier == "Texture") { addTexture(tempVector[0], tempVector[1]); }
-			else if (identifier == "Animation")
+		tileNames.clear();
+		std::string_view extra;
+		while (tokenizer.nextOnLine(extra))
+		{
+			if (format->record == Record::Tilesheet) { tileNames.push_back(extra); }
+			else
 			{
-				size_t frameCount, interval;
-				// std::istringstream can be used to store the input strings into a different data type
-				std::stringstream ss(tempVector[2]);
-				std::stringstream ss2(tempVector[3]);
-				ss >> frameCount;
-				ss2 >> interval;
-				addAnimation(tempVector[0], tempVector[1], frameCount, interval);
-				ss.clear();
-				ss2.clear();
+				std::cerr << path << ":" << line << ":" << tokenizer.column() << ": ignoring extra fields after " << format->usage << std::endl;
+				break;
 			}
-			else if (identifier == "Font") { addFont(tempVector[0], tempVector[1]); }
+		}
+		tokenizer.skipLine();
 
-			// clear vector for next line's data
-			tempVector.clear();
+		switch (format->record)
+		{
+		case Record::Texture:
+			queueAsset(PendingAsset::Kind::Texture, std::string(fields[0]), std::string(fields[1]));
+			break;
+		case Record::Animation:
+		{
+			// Animations reference textures by name, but textures only get their place in the atlas once
+			// every texture has been decoded, so animations are created when loading finishes
+			size_t frameCount = 0, speed = 0;
+			if (!Tokenizer::toNumber(fields[2], frameCount) || frameCount == 0)
+			{
+				reportError(line, fieldColumns[2], "frame count must be a positive whole number, not '" + std::string(fields[2]) + "'");
+				break;
+			}
+			if (!Tokenizer::toNumber(fields[3], speed))
+			{
+				reportError(line, fieldColumns[3], "speed must be a whole number of game frames, not '" + std::string(fields[3]) + "'");
+				break;
+			}
+			m_animationDefinitions.push_back({ std::string(fields[0]), std::string(fields[1]), frameCount, speed });
+			break;
 		}
+		case Record::Tilesheet:
+			queueAsset(PendingAsset::Kind::Tilesheet, std::string(fields[0]), std::string(fields[1]), tileNames);
+			break;
+		case Record::Font:
+			addFont(std::string(fields[0]), std::string(fields[1]));
+			m_files.push_back({ AssetFile::Kind::Font, std::string(fields[0]), std::string(fields[1]) });
+			break;
+		case Record::Sound:
+			queueAsset(PendingAsset::Kind::Sound, std::string(fields[0]), std::string(fields[1]));
+			m_files.push_back({ AssetFile::Kind::Sound, std::string(fields[0]), std::string(fields[1]) });
+			break;
+		case Record::Music:
+			addMusic(std::string(fields[0]), std::string(fields[1]));
+			m_files.push_back({ AssetFile::Kind::Music, std::string(fields[0]), std::string(fields[1]) });
+			break;
+		}
+	}
+
+	return true;
+}
 
-		// clean up for memory mapping
-		mm.close();
+void Assets::queueAsset(PendingAsset::Kind kind, const std::string& name, const std::string& path, const std::vector<std::string_view>& tileNames)
+{
+	m_pendingAssets.push_back({ kind, name, path });
+	PendingAsset* asset = &m_pendingAssets.back();
+	for (auto tileName : tileNames)
+	{
+		asset->tileNames.emplace_back(tileName);
 	}
-	catch (...)
+
+	m_loader->add([this, asset] { decodeAsset(*asset); });
+}
+
+// Runs on a worker thread. Only touches the asset it was given and reads m_tileSize, which doesn't change while loading.
+void Assets::decodeAsset(PendingAsset& asset) const
+{
+	switch (asset.kind)
 	{
-		// Simple to help me debug - if there's an issue here more robust error handling would be good
-		// but for now we want to swallow the errors and try to continue
-		std::cout << "Unknown error encountered while attempting to read file.\n";
-		return false;
+	case PendingAsset::Kind::Texture:
+		if (!asset.image.loadFromFile(asset.path))
+		{
+			asset.error = "Could not load texture file: " + asset.path;
+		}
+		break;
+	case PendingAsset::Kind::Tilesheet:
+		processTilesheet(asset);
+		break;
+	case PendingAsset::Kind::Sound:
+		if (!asset.sound.loadFromFile(asset.path))
+		{
+			asset.error = "Could not load sound file: " + asset.path;
+		}
+		break;
 	}
-	
+}
+
+// Call once a frame while loading. Returns true once everything has loaded, after moving the decoded
+// assets into place and uploading the atlas - the only part that has to happen on the main thread.
+bool Assets::updateLoading()
+{
+	if (!m_loader) { return true; }
+	if (!m_loader->done()) { return false; }
 
+	finishLoading();
 	return true;
 }
 
-void Assets::addTexture(const std::string& textureName, const std::string& path, bool smooth)
+void Assets::finishLoading()
 {
-	m_textureMap[textureName] = sf::Texture();
+	// Added in file order so the atlas layout doesn't depend on which thread finished first
+	for (auto& asset : m_pendingAssets)
+	{
+		// Counted with the parse errors, so a load with missing images or sounds doesn't report success
+		if (!asset.error.empty())
+		{
+			std::cerr << asset.error << std::endl;
+			m_loadErrors++;
+		}
+
+		switch (asset.kind)
+		{
+		case PendingAsset::Kind::Texture:
+			// Animation strips are smoothed like addTexture used to, tiles below are left pixel exact
+			if (asset.error.empty()) { m_atlas.add(asset.name, std::move(asset.image), true); }
+			break;
+		case PendingAsset::Kind::Tilesheet:
+			for (auto& tile : asset.tiles)
+			{
+				m_atlas.add(tile.first, asset.tilesheet, tile.second);
+			}
+			break;
+		case PendingAsset::Kind::Sound:
+			if (asset.error.empty())
+			{
+				// The sound keeps a pointer to its buffer, so it has to be the one in the map
+				m_soundBufferMap[asset.name] = std::move(asset.sound);
+				m_soundMap[asset.name] = std::make_unique<sf::Sound>(m_soundBufferMap[asset.name]);
+			}
+			break;
+		}
+	}
 
-	if (!m_textureMap[textureName].loadFromFile(path))
+	m_atlas.build();
+	for (auto& a : m_animationDefinitions)
 	{
-		std::cerr << "Could not load texture file: " << path << std::endl;
+		addAnimation(a.name, a.textureName, a.frameCount, a.speed);
 	}
-	else
+
+	if (m_loadErrors > 0)
 	{
-		m_textureMap[textureName].setSmooth(smooth);
+		std::cerr << m_loadingPath << ": " << m_loadErrors << " line(s) or file(s) could not be loaded" << std::endl;
 	}
+
+	m_pendingAssets.clear();
+	m_loader.reset();
+}
+
+// Fraction of the queued files decoded so far
+float Assets::loadingProgress() const
+{
+	if (!m_loader || m_loader->queued() == 0) { return 1.0f; }
+	return (float)m_loader->finished() / m_loader->queued();
+}
+
+bool Assets::isLoading() const
+{
+	return m_loader != nullptr;
 }
 
-const sf::Texture& Assets::getTexture(const std::string& textureName) const
+bool Assets::loadSucceeded() const
 {
-	assert(m_textureMap.find(textureName) != m_textureMap.end());
-	return m_textureMap.at(textureName);
+	return !isLoading() && m_loadErrors == 0;
 }
 
-bool Assets::isTileEmpty(const sf::Image& tileImage, Vec2& tileSize)
+// Copies record index of a pack section out of the mapped file, false if the section isn't that big
+template <typename T>
+static bool readPackRecord(const char* data, const PackSection& section, size_t index, T& record)
 {
-	for (unsigned int x = 0; x < tileSize.x; ++x)
+	if (index >= section.count || (index + 1) * sizeof(T) > section.size) { return false; }
+
+	std::memcpy(&record, data + section.offset + index * sizeof(T), sizeof(T));
+	return true;
+}
+
+static bool isInPackSection(const PackSection& section, uint64_t offset, uint64_t length)
+{
+	return offset <= section.size && length <= section.size - offset;
+}
+
+// Everything in the pack was already decoded, sliced and packed by the asset packer, so this only
+// checks the table of contents and hands the mapped bytes over. The mapping stays open afterwards
+// because fonts read their glyphs from it for as long as they're used.
+bool Assets::loadFromPack(const std::string& path)
+{
+	m_loadErrors = 0;
+	m_pack = std::make_unique<MemoryMapping>(path);
+	if (!m_pack->isOpen()) { return false; }
+
+	const char* data = m_pack->data();
+	const size_t size = m_pack->size();
+	auto packError = [&](const std::string& message)
+	{
+		std::cerr << path << ": " << message << std::endl;
+		m_loadErrors++;
+		return false;
+	};
+
+	PackHeader header;
+	if (size < sizeof(header)) { return packError("too small to be an asset pack"); }
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) != 0) { return packError("not an asset pack"); }
+	if (header.version != ASSET_PACK_VERSION)
 	{
-		for (unsigned int y = 0; y < tileSize.y; ++y)
+		return packError("pack is version " + std::to_string(header.version) + ", expected " + std::to_string(ASSET_PACK_VERSION) + " - rebuild it with AssetPacker");
+	}
+	if (header.sectionCount > (size - sizeof(header)) / sizeof(PackSection)) { return packError("table of contents is cut short"); }
+
+	// Sections this version doesn't know about are skipped, missing ones are left empty
+	PackSection sections[(size_t)PackSectionId::Count] = {};
+	for (uint32_t i = 0; i < header.sectionCount; i++)
+	{
+		PackSection section;
+		std::memcpy(&section, data + sizeof(header) + i * sizeof(PackSection), sizeof(section));
+		if (section.offset > size || section.size > size - section.offset) { return packError("section " + std::to_string(section.id) + " runs past the end of the file"); }
+		if (section.id < (uint32_t)PackSectionId::Count) { sections[section.id] = section; }
+	}
+
+	const PackSection& strings = sections[(size_t)PackSectionId::Strings];
+	auto readString = [&](const PackString& packString, std::string& out)
+	{
+		if (!isInPackSection(strings, packString.offset, packString.length)) { return false; }
+		out.assign(data + strings.offset + packString.offset, packString.length);
+		return true;
+	};
+
+	const PackSection& pages = sections[(size_t)PackSectionId::Pages];
+	const PackSection& pixels = sections[(size_t)PackSectionId::Pixels];
+	for (uint32_t i = 0; i < pages.count; i++)
+	{
+		PackPage page;
+		if (!readPackRecord(data, pages, i, page) ||
+			!isInPackSection(pixels, page.pixelOffset, (uint64_t)page.width * page.height * 4))
 		{
-			if (tileImage.getPixel({ x, y }).a != 0)
+			return packError("atlas page " + std::to_string(i) + " is damaged");
+		}
+		m_atlas.addPage((const std::uint8_t*)(data + pixels.offset + page.pixelOffset), { page.width, page.height }, page.smooth != 0);
+	}
+
+	std::string name, textureName;
+	const PackSection& regions = sections[(size_t)PackSectionId::Regions];
+	for (uint32_t i = 0; i < regions.count; i++)
+	{
+		PackRegion region;
+		if (!readPackRecord(data, regions, i, region) || !readString(region.name, name) || region.page >= m_atlas.pageCount())
+		{
+			return packError("atlas region " + std::to_string(i) + " is damaged");
+		}
+		m_atlas.addRegion(name, { region.page, sf::IntRect({ region.x, region.y }, { region.width, region.height }) });
+	}
+
+	const PackSection& animations = sections[(size_t)PackSectionId::Animations];
+	for (uint32_t i = 0; i < animations.count; i++)
+	{
+		PackAnimation animation;
+		if (!readPackRecord(data, animations, i, animation) || !readString(animation.name, name) || !readString(animation.textureName, textureName))
+		{
+			return packError("animation " + std::to_string(i) + " is damaged");
+		}
+		m_animationDefinitions.push_back({ name, textureName, animation.frameCount, animation.speed });
+		addAnimation(name, textureName, animation.frameCount, animation.speed);
+	}
+
+	const PackSection& files = sections[(size_t)PackSectionId::Files];
+	const PackSection& fileData = sections[(size_t)PackSectionId::Data];
+	for (uint32_t i = 0; i < files.count; i++)
+	{
+		PackFile file;
+		if (!readPackRecord(data, files, i, file) || !readString(file.name, name) || !isInPackSection(fileData, file.dataOffset, file.dataSize))
+		{
+			return packError("file " + std::to_string(i) + " is damaged");
+		}
+
+		const char* bytes = data + fileData.offset + file.dataOffset;
+		switch ((PackFileKind)file.kind)
+		{
+		case PackFileKind::Font:
+			if (!m_fontMap[name].openFromMemory(bytes, (size_t)file.dataSize))
+			{
+				std::cerr << path << ": could not open font " << name << std::endl;
+			}
+			m_files.push_back({ AssetFile::Kind::Font, name, path });
+			break;
+		case PackFileKind::Sound:
+			if (!m_soundBufferMap[name].loadFromMemory(bytes, (size_t)file.dataSize))
 			{
-				return false;
+				std::cerr << path << ": could not load sound " << name << std::endl;
+				m_soundBufferMap.erase(name);
+				break;
 			}
+			m_soundMap[name] = std::make_unique<sf::Sound>(m_soundBufferMap[name]);
+			m_files.push_back({ AssetFile::Kind::Sound, name, path });
+			break;
+		case PackFileKind::Music:
+			// Music is streamed, the pack only has its path
+			addMusic(name, std::string(bytes, (size_t)file.dataSize));
+			m_files.push_back({ AssetFile::Kind::Music, name, m_musicMap[name] });
+			break;
+		default:
+			std::cerr << path << ": skipping file " << name << " of unknown kind " << file.kind << std::endl;
+			break;
 		}
 	}
+
+	std::cout << "Loaded " << m_atlas.pageCount() << " atlas page(s), " << regions.count << " regions and "
+		<< animations.count << " animations from " << path << "\n";
 	return true;
 }
 
-void Assets::processTilesheet(const std::string& tilesheetName, const std::string& path, std::vector<std::string>& tileNames)
+// Call before loading starts. With upload off the atlas is laid out but never sent to the GPU.
+void Assets::setUploadTextures(bool upload)
+{
+	m_atlas.setUpload(upload);
+}
+
+// Call before loading starts. Keeps the packed atlas pages in memory for TextureAtlas::getPageImage.
+void Assets::setKeepAtlasPixels(bool keep)
+{
+	m_atlas.setKeepPixels(keep);
+}
+
+const TextureAtlas& Assets::getAtlas() const
 {
-	sf::Image tilesheet;
-	if (!tilesheet.loadFromFile(path))
+	return m_atlas;
+}
+
+// True if none of the count RGBA pixels starting at pixels has any alpha
+static bool isSpanTransparent(const std::uint8_t* pixels, size_t count)
+{
+	size_t i = 0;
+
+#if ASSETS_SSE2
+	// OR four pixels at a time into one register, then check the alpha bytes (the top byte of each
+	// little endian pixel) once at the end. A 64 pixel tile row is 16 loads and a single compare.
+	const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+	__m128i seen = _mm_setzero_si128();
+	for (; i + 4 <= count; i += 4)
 	{
-		std::cerr << "Could not load tilesheet: " << path << std::endl;
+		seen = _mm_or_si128(seen, _mm_loadu_si128((const __m128i*)(pixels + i * 4)));
 	}
-	else
+
+	__m128i alphaIsZero = _mm_cmpeq_epi8(_mm_and_si128(seen, alphaMask), _mm_setzero_si128());
+	if (_mm_movemask_epi8(alphaIsZero) != 0xFFFF) { return false; }
+#endif
+
+	for (; i < count; i++)
 	{
-		const int numberOfRows = (int)(tilesheet.getSize().y / m_tileSize.y);
-		const int numberOfColumns = (int)(tilesheet.getSize().x / m_tileSize.x);
+		if (pixels[i * 4 + 3] != 0) { return false; }
+	}
+	return true;
+}
 
-		// Initialize the tile object
-		sf::Image tile;
-		tile.resize({ (unsigned int)m_tileSize.x, (unsigned int)m_tileSize.y });
+// Works on the sheet's pixels in place, one row span at a time, and stops at the first row with anything in it
+bool Assets::isTileEmpty(const sf::Image& tilesheet, const sf::IntRect& tileRect) const
+{
+	const std::uint8_t* pixels = tilesheet.getPixelsPtr();
+	const size_t stride = (size_t)tilesheet.getSize().x * 4;
 
-		int tileNameIndex = 2;
-		for (size_t c = 0; c < numberOfColumns; ++c)
+	for (int y = 0; y < tileRect.size.y; ++y)
+	{
+		const std::uint8_t* row = pixels + (size_t)(tileRect.position.y + y) * stride + (size_t)tileRect.position.x * 4;
+		if (!isSpanTransparent(row, (size_t)tileRect.size.x))
 		{
-			for (size_t r = 0; r < numberOfRows; ++r)
+			return false;
+		}
+	}
+	return true;
+}
+
+// Runs on a worker thread, finds the tiles in the sheet and names them in order. Nothing is copied here:
+// the atlas takes each tile as a rect of the shared sheet and copies it straight into its page.
+void Assets::processTilesheet(PendingAsset& tilesheetAsset) const
+{
+	auto tilesheet = std::make_shared<sf::Image>();
+	if (!tilesheet->loadFromFile(tilesheetAsset.path))
+	{
+		tilesheetAsset.error = "Could not load tilesheet: " + tilesheetAsset.path;
+		return;
+	}
+
+	const int numberOfRows = (int)(tilesheet->getSize().y / m_tileSize.y);
+	const int numberOfColumns = (int)(tilesheet->getSize().x / m_tileSize.x);
+	const std::vector<std::string>& tileNames = tilesheetAsset.tileNames;
+	tilesheetAsset.tilesheet = tilesheet;
+
+	size_t tileNameIndex = 0;
+	for (int c = 0; c < numberOfColumns; ++c)
+	{
+		for (int r = 0; r < numberOfRows; ++r)
+		{
+			// Create a rect at the position the tile exists on the tilesheet
+			sf::IntRect tileRect({ (int)(c * m_tileSize.x), (int)(r * m_tileSize.y) }, { (int)m_tileSize.x, (int)m_tileSize.y });
+
+			// Tilesheets are not always symmetrical with their grid, which can leave empty cells that aren't tiles
+			if (isTileEmpty(*tilesheet, tileRect)) { continue; }
+
+			if (tileNameIndex >= tileNames.size())
 			{
-				// Create a rect at the position the tile exists on the tilesheet
-				sf::IntRect tileRect({ (int)(c * m_tileSize.x), (int)(r * m_tileSize.y) }, { (int)m_tileSize.x, (int)m_tileSize.y });
-
-				// Copy the pixels in the subregion defined by the sf::IntRect.
-				// SFML documentation says this is a slow pixel copy so will look to optimze in the future.
-				// Since tilesheets are not always symmetrical with their grid, that can leave empty space in the tilesheet.
-				// sf::Image has a function to get a pixel at a position so we are using that function to ignore empty space.
-				// For this reason, sf::Image is used over sf::Texture.
-				tile.copy(tilesheet, { 0, 0 }, tileRect);
-
-				if (!isTileEmpty(tile, m_tileSize))
-				{
-					// Create a texture from the sf::Image to create a tile usable by the animation system.
-					sf::Texture texTile;
-					texTile.loadFromImage(tile);
-					m_textureMap[tileNames[tileNameIndex]] = texTile;
-					++tileNameIndex;
-				}
+				tilesheetAsset.error = "Tilesheet " + tilesheetAsset.name + " has more tiles than names, the rest are skipped";
+				return;
 			}
+
+			tilesheetAsset.tiles.emplace_back(tileNames[tileNameIndex], tileRect);
+			++tileNameIndex;
+		}
+	}
+}
+
+// Animation names are <EntityName><Type>, e.g. "PlayerRun". Finds the first type keyword in the name,
+// returning its position in typePos, or AnimationType::None if the name has no type.
+static AnimationType parseAnimationType(const std::string& animationName, size_t& typePos)
+{
+	static const std::pair<const char*, AnimationType> types[] =
+	{
+		{ "Run", AnimationType::Run },
+		{ "Jump", AnimationType::Jump },
+		{ "Crouch", AnimationType::Crouch },
+		{ "Idle", AnimationType::Idle },
+		{ "Dead", AnimationType::Dead },
+		{ "Rush", AnimationType::Rush },
+		{ "Shoot", AnimationType::Shoot }
+	};
+
+	AnimationType type = AnimationType::None;
+	typePos = std::string::npos;
+	for (auto& t : types)
+	{
+		size_t pos = animationName.find(t.first);
+		if (pos < typePos)
+		{
+			typePos = pos;
+			type = t.second;
 		}
 	}
+	return type;
+}
+
+AnimationEntityId Assets::internAnimationEntity(const std::string& entityName)
+{
+	auto it = m_animationEntityIds.find(entityName);
+	if (it != m_animationEntityIds.end())
+	{
+		return it->second;
+	}
+
+	AnimationEntityId id = (AnimationEntityId)m_animationTable.size();
+	m_animationEntityIds[entityName] = id;
+	m_animationTable.emplace_back();
+	m_animationTable.back().fill(nullptr);
+	return id;
 }
 
 void Assets::addAnimation(const std::string& animationName, const std::string& textureName, size_t frameCount, size_t speed)
 {
-	m_animationMap[animationName] = Animation(animationName, getTexture(textureName), frameCount, speed);
+	Animation& animation = m_animationMap[animationName];
+	if (m_atlas.hasRegion(textureName))
+	{
+		const AtlasRegion& region = m_atlas.getRegion(textureName);
+		animation = Animation(animationName, m_atlas.getPage(region.page), region.rect, frameCount, speed);
+	}
+	else
+	{
+		std::cerr << "Animation " << animationName << " uses unknown texture: " << textureName << std::endl;
+		animation = Animation(animationName, Animation::getDummyTexture(), frameCount, speed);
+	}
+
+	size_t typePos;
+	AnimationType type = parseAnimationType(animationName, typePos);
+	if (type == AnimationType::None)
+	{
+		// Single animation entities (trees, hearts, lamps...) never swap animations
+		return;
+	}
+
+	AnimationEntityId entityId = internAnimationEntity(animationName.substr(0, typePos));
+	animation.setMetadata(entityId, type);
+	m_animationTable[entityId][(size_t)type] = &animation;
 }
 
 const Animation& Assets::getAnimation(const std::string& animationName) const
@@ -172,6 +617,21 @@ const Animation& Assets::getAnimation(const std::string& animationName) const
 	return m_animationMap.at(animationName);
 }
 
+// Throws std::out_of_range like getAnimation(name) when the entity has no clip of that type
+const Animation& Assets::getAnimation(AnimationEntityId entityId, AnimationType type) const
+{
+	if (!hasAnimation(entityId, type))
+	{
+		throw std::out_of_range("No animation of type " + std::to_string((size_t)type) + " for animation entity " + std::to_string(entityId));
+	}
+	return *m_animationTable[entityId][(size_t)type];
+}
+
+bool Assets::hasAnimation(AnimationEntityId entityId, AnimationType type) const
+{
+	return entityId < m_animationTable.size() && m_animationTable[entityId][(size_t)type] != nullptr;
+}
+
 void Assets::addFont(const std::string& fontName, const std::string& path)
 {
 	m_fontMap[fontName] = sf::Font();
@@ -187,17 +647,6 @@ const sf::Font& Assets::getFont(const std::string& fontName) const
 	return m_fontMap.at(fontName);
 }
 
-void Assets::addSound(const std::string& soundName, const std::string& path)
-{
-	sf::SoundBuffer buffer;
-	if (buffer.loadFromFile(path))
-	{
-		m_soundBufferMap[soundName] = buffer;
-		m_soundMap[soundName] = std::make_unique<sf::Sound>(buffer);
-	}
-	else { std::cerr << "Buffer couldn't load from file."; }
-}
-
 std::unique_ptr<sf::Sound>& Assets::getSound(const std::string& soundName)
 {
 	return m_soundMap.at(soundName);
@@ -213,11 +662,6 @@ const std::string& Assets::getMusic(const std::string& musicName) const
 	return m_musicMap.at(musicName);
 }
 
-const std::map<std::string, sf::Texture>& Assets::getTextures() const
-{
-	return m_textureMap;
-}
-
 const std::map<std::string, Animation>& Assets::getAnimations() const
 {
 	return m_animationMap;
@@ -228,6 +672,16 @@ const std::map<std::string, std::unique_ptr<sf::Sound>>& Assets::getSounds() con
 	return m_soundMap;
 }
 
+const std::vector<Assets::AnimationDefinition>& Assets::getAnimationDefinitions() const
+{
+	return m_animationDefinitions;
+}
+
+const std::vector<Assets::AssetFile>& Assets::getFiles() const
+{
+	return m_files;
+}
+
 const std::map<std::string, std::string>& Assets::getMusic() const
 {
 	return m_musicMap;
@@ -1,13 +1,54 @@
 #pragma once
 
 #include "Animation.h"
+#include "AssetLoader.h"
+#include "MemoryMapping.h"
+#include "TextureAtlas.h"
 #include <SFML/Audio.hpp>
+#include <deque>
 #include <map>
+#include <memory>
+#include <string_view>
+#include <array>
+#include <unordered_map>
 
 class Assets
 {
+	// A file handed to the loader. A worker fills in the decoded data and the main thread
+	// moves it into the maps (and the atlas) once every job has finished.
+	struct PendingAsset
+	{
+		enum class Kind { Texture, Tilesheet, Sound };
+
+		Kind										kind;
+		std::string									name;
+		std::string									path;
+		std::vector<std::string>					tileNames;		// Tilesheets only
+		sf::Image									image;			// Textures only
+		std::shared_ptr<const sf::Image>			tilesheet;
+		std::vector<std::pair<std::string, sf::IntRect>>	tiles;		// Where each named tile is on the tilesheet
+		sf::SoundBuffer								sound;
+		std::string									error;			// Set by the worker, reported in file order
+	};
+
+public:
+	// What was loaded from where, kept so the asset packer can write it all out
+	struct AnimationDefinition
+	{
+		std::string		name, textureName;
+		size_t			frameCount, speed;
+	};
+
+	struct AssetFile
+	{
+		enum class Kind { Font, Sound, Music };
+
+		Kind			kind;
+		std::string		name, path;
+	};
+
 private:
-	std::map<std::string, sf::Texture>						m_textureMap;
+	TextureAtlas											m_atlas;
 	std::map<std::string, Animation>						m_animationMap;
 	std::map<std::string, sf::Font>							m_fontMap;
 	std::map<std::string, sf::SoundBuffer>					m_soundBufferMap;
@@ -15,26 +56,56 @@ private:
 	std::map<std::string, std::string>						m_musicMap;
 	Vec2													m_tileSize = { 64, 64 };
 
-	void addTexture(const std::string& textureName, const std::string& path, bool smooth = true);
-	bool isTileEmpty(const sf::Image& tileImage, Vec2& tileSize);
-	void processTilesheet(const std::string& tilesheetName, const std::string& path, std::vector<std::string>& tileNames);
+	// (entity, type) -> animation, filled in by addAnimation. Points into m_animationMap, whose nodes never move.
+	typedef std::array<const Animation*, (size_t)AnimationType::Count> AnimationTypeTable;
+	std::unordered_map<std::string, AnimationEntityId>		m_animationEntityIds;
+	std::vector<AnimationTypeTable>							m_animationTable;
+
+	std::vector<AnimationDefinition>						m_animationDefinitions;
+	std::vector<AssetFile>									m_files;
+	std::unique_ptr<MemoryMapping>							m_pack;					// Fonts from a pack are read from it while they're in use
+
+	// Only set while a load is in progress, so the worker threads go away once it's done.
+	// The order matters: members are destroyed last to first, so m_loader joins its workers
+	// before the assets they are still writing into are freed (e.g. quitting mid-load).
+	std::deque<PendingAsset>								m_pendingAssets;		// Deque so the jobs' pointers stay valid
+	std::unique_ptr<AssetLoader>							m_loader;
+	std::string												m_loadingPath;
+	size_t													m_loadErrors = 0;
+
+	void queueAsset(PendingAsset::Kind kind, const std::string& name, const std::string& path, const std::vector<std::string_view>& tileNames = {});
+	void decodeAsset(PendingAsset& asset) const;
+	void finishLoading();
+	bool loadFromPack(const std::string& path);
+	bool isTileEmpty(const sf::Image& tilesheet, const sf::IntRect& tileRect) const;
+	void processTilesheet(PendingAsset& tilesheet) const;
 	void addAnimation(const std::string& animationName, const std::string& textureName, size_t frameCount, size_t speed);
+	AnimationEntityId internAnimationEntity(const std::string& entityName);
 	void addFont(const std::string& fontName, const std::string& path);
-	void addSound(const std::string& soundName, const std::string& path);
 	void addMusic(const std::string& musicName, const std::string& path);
 
 public:
     Assets();
 
     bool loadFromFile(const std::string& path);
+	bool beginLoading(const std::string& path);
+	bool updateLoading();
+	float loadingProgress() const;
+	bool isLoading() const;
+	bool loadSucceeded() const;
+	void setUploadTextures(bool upload);
+	void setKeepAtlasPixels(bool keep);
 
-	const std::map<std::string, sf::Texture>& getTextures() const;
+	const TextureAtlas& getAtlas() const;
 	const std::map<std::string, Animation>& getAnimations() const;
 	const std::map<std::string, std::unique_ptr<sf::Sound>>& getSounds() const;
 	const std::map<std::string, std::string>& getMusic() const;
+	const std::vector<AnimationDefinition>& getAnimationDefinitions() const;
+	const std::vector<AssetFile>& getFiles() const;
 
-	const sf::Texture& getTexture(const std::string& textureName) const;
 	const Animation& getAnimation(const std::string& animationName) const;
+	const Animation& getAnimation(AnimationEntityId entityId, AnimationType type) const;
+	bool hasAnimation(AnimationEntityId entityId, AnimationType type) const;
 	const sf::Font& getFont(const std::string& fontName) const;
 	std::unique_ptr<sf::Sound>& getSound(const std::string& soundName);
 	const std::string& getMusic(const std::string& musicName) const;
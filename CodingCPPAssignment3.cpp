@@ -1,18 +1,84 @@
 // CodingCPPAssignment3.cpp : This file contains the 'main' function. Program execution begins and ends there. Or does it?
 
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <SFML/Graphics.hpp>
 #include "GameEngine.h"
+#include "Tokenizer.h"
 
 #include "Profiler.h"
 
-int main()
+// Usage:
+//		CodingCPPAssignment3 [--assets <file>] [--record <file>] [--profile <file>]
+//		CodingCPPAssignment3 --headless <level> [--input <script>] [--ticks <count>] [--record <file>] [--profile <file>]
+//		CodingCPPAssignment3 --replay <file> [--ticks <count>] [--profile <file>]
+// --profile captures a trace of the whole run, F4 starts and stops one while playing (needs PROFILING defined)
+// --assets defaults to assets/assets.pack when tools/AssetPacker has made one, and assets/assets.txt otherwise
+int main(int argc, char* argv[])
 {
-    //PROFILE_FUNCTION();
     std::cout << "Booting up!\n";
+
+    HeadlessSettings headless;
+    std::string recordPath;
+    std::string profilePath;
+    std::string assetsPath;
+    bool isHeadless = false;
+    auto usage = [&]()
+    {
+        std::cerr << "Usage: " << argv[0] << " [--headless <level> [--input <script>] | --replay <file>] [--ticks <count>] [--assets <file>] [--record <file>] [--profile <file>]\n";
+        return 1;
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--headless" && i + 1 < argc)    { isHeadless = true; headless.levelPath = argv[++i]; }
+        else if (arg == "--input" && i + 1 < argc)  { headless.inputPath = argv[++i]; }
+        else if (arg == "--ticks" && i + 1 < argc)
+        {
+            // Whole non-negative numbers only, "abc" or "-5" would otherwise throw or wrap around
+            if (!Tokenizer::toNumber(argv[++i], headless.ticks))
+            {
+                std::cerr << "--ticks needs a whole number of ticks, not '" << argv[i] << "'\n";
+                return usage();
+            }
+        }
+        else if (arg == "--replay" && i + 1 < argc) { isHeadless = true; headless.replayPath = argv[++i]; }
+        else if (arg == "--record" && i + 1 < argc) { recordPath = argv[++i]; }
+        else if (arg == "--profile" && i + 1 < argc){ profilePath = argv[++i]; }
+        else if (arg == "--assets" && i + 1 < argc) { assetsPath = argv[++i]; }
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return usage();
+        }
+    }
+
+    if (!profilePath.empty()) { Profiler::Instance().startCapture(profilePath); }
+
+    if (assetsPath.empty())
+    {
+        assetsPath = std::ifstream("assets/assets.pack").is_open() ? "assets/assets.pack" : "assets/assets.txt";
+    }
+
     std::cout << "Passing assets to game engine now.\n";
-    GameEngine g("assets/assets.txt");
-    g.run();
+    int exitCode = 0;
+    if (isHeadless)
+    {
+        GameEngine g(assetsPath, headless);
+        g.setRecordPath(recordPath);
+        g.run();
+        exitCode = g.exitCode();
+    }
+    else
+    {
+        GameEngine g(assetsPath);
+        g.setRecordPath(recordPath);
+        g.run();
+        exitCode = g.exitCode();
+    }
 
-    return 0;
+    Profiler::Instance().stopCapture();
+    return exitCode;
 }
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Sparse set storage for a single component type.
+// Live components are packed together in m_dense so iterating one component type only touches
+// live data, while m_sparse maps an entity id to its slot in m_dense for O(1) lookups.
+// Memory scales with the number of live components instead of MAX_ENTITIES.
+//
+// NOTE: adding or removing a component can move other components of the same type,
+// so don't hold a reference to a component across an addComponent/removeComponent/destroy of the same type.
+template <typename T>
+class ComponentPool
+{
+	static constexpr uint32_t		NONE = UINT32_MAX;
+
+	std::vector<T>					m_dense;					// Live components, packed
+	std::vector<size_t>				m_denseToEntity;			// Entity id owning each element of m_dense
+	std::vector<uint32_t>			m_sparse;					// Entity id -> index into m_dense (NONE if missing)
+	T								m_missing;					// Handed out by get() for entities without this component
+
+public:
+
+	bool has(size_t entityId) const
+	{
+		return entityId < m_sparse.size() && m_sparse[entityId] != NONE;
+	}
+
+	// Entities without this component get a default constructed (has == false) component.
+	// Writes to it are discarded, so always add a component before modifying it.
+	T& get(size_t entityId)
+	{
+		if (!has(entityId))
+		{
+			m_missing = T();
+			return m_missing;
+		}
+
+		return m_dense[m_sparse[entityId]];
+	}
+
+	template <typename... TArgs>
+	T& add(size_t entityId, TArgs&&... mArgs)
+	{
+		// Construct first - the arguments may reference another element of m_dense
+		// which would dangle if the push_back below reallocates
+		T component(std::forward<TArgs>(mArgs)...);
+		component.has = true;
+
+		if (has(entityId))
+		{
+			T& existing = m_dense[m_sparse[entityId]];
+			existing = std::move(component);
+			return existing;
+		}
+
+		if (entityId >= m_sparse.size())
+		{
+			m_sparse.resize(entityId + 1, NONE);
+		}
+
+		m_sparse[entityId] = (uint32_t)m_dense.size();
+		m_denseToEntity.push_back(entityId);
+		m_dense.push_back(std::move(component));
+		return m_dense.back();
+	}
+
+	// Swap the last component into the removed slot to keep m_dense packed
+	void remove(size_t entityId)
+	{
+		if (!has(entityId)) { return; }
+
+		uint32_t index = m_sparse[entityId];
+		uint32_t last = (uint32_t)m_dense.size() - 1;
+
+		if (index != last)
+		{
+			m_dense[index] = std::move(m_dense[last]);
+			m_denseToEntity[index] = m_denseToEntity[last];
+			m_sparse[m_denseToEntity[index]] = index;
+		}
+
+		m_dense.pop_back();
+		m_denseToEntity.pop_back();
+		m_sparse[entityId] = NONE;
+	}
+
+	size_t size() const
+	{
+		return m_dense.size();
+	}
+
+	// Packed components and the entity id owning each one, index for index
+	std::vector<T>& components()
+	{
+		return m_dense;
+	}
+
+	const std::vector<size_t>& entityIds() const
+	{
+		return m_denseToEntity;
+	}
+};
@@ -2,22 +2,59 @@
 
 #include "Animation.h"
 
+#include <cstdint>
+
 class Component
 {
 public:
 	bool has = false;
 };
 
+// Per-entity playback of a shared Animation clip owned by Assets
 class CAnimation : public Component
 {
 public:
-	Animation animation;
+	const Animation* animation = &Animation::getEmpty();
+	uint32_t currentFrame = 0;		// Game frames the clip has been playing for
 	bool repeat = false;
 	CAnimation() {};
 	CAnimation(const Animation& ani) :
-		animation(ani), repeat(false) { }
+		animation(&ani), repeat(false) { }
 	CAnimation(const Animation& ani, bool r) :
-		animation(ani), repeat(r) { }
+		animation(&ani), repeat(r) { }
+
+	// Start playing a different clip from its first frame
+	void play(const Animation& ani)
+	{
+		animation = &ani;
+		currentFrame = 0;
+	}
+
+	void update()
+	{
+		if (animation->getSpeed() != 0) { currentFrame++; }
+	}
+
+	bool hasEnded() const
+	{
+		return currentFrame == animation->getDuration();
+	}
+
+	const sf::IntRect& getTextureRect() const
+	{
+		return animation->getFrameRect(currentFrame);
+	}
+
+	// Sprite for drawing the current frame at the given transform
+	sf::Sprite getSprite(const Vec2& pos, const Vec2& scale, float angle) const
+	{
+		sf::Sprite sprite = animation->getSprite();
+		sprite.setTextureRect(getTextureRect());
+		sprite.setRotation(sf::degrees(angle));
+		sprite.setPosition({ pos.x, pos.y });
+		sprite.setScale({ scale.x, scale.y });
+		return sprite;
+	}
 };
 
 class CAttacking : public Component
@@ -171,12 +208,69 @@ public:
 		source(origin), targets(endPoints) {}
 };
 
+enum class State : uint8_t
+{
+	Alive,			// Spawned, no behaviour specific state yet
+	Idle,
+	Running,
+	Jumping,
+	Climbing,
+	Crouching,
+	Shooting,
+	Rush,
+	Dead,
+	Count
+};
+
 class CState : public Component
 {
+	State	m_state = State::Alive;
+	State	m_handled = State::Alive;		// Last state sStatus reacted to
+
+	// Bitmask of the states each state is allowed to move to, indexed by the current state.
+	// Alive is only ever a spawn state and Dead is terminal. Whether the move makes sense right now
+	// (e.g. a ladder to climb, ground to run on) is still up to the system asking for it.
+	static constexpr uint16_t StateBit(State s) { return (uint16_t)(1u << (uint8_t)s); }
+
+	static bool canTransition(State from, State to)
+	{
+		constexpr uint16_t Idle = StateBit(State::Idle), Running = StateBit(State::Running), Jumping = StateBit(State::Jumping),
+			Climbing = StateBit(State::Climbing), Crouching = StateBit(State::Crouching), Shooting = StateBit(State::Shooting),
+			Rush = StateBit(State::Rush), Dead = StateBit(State::Dead);
+
+		static constexpr uint16_t transitions[(size_t)State::Count] =
+		{
+			Idle | Running | Jumping | Climbing | Crouching | Shooting | Rush | Dead,		// Alive
+			Running | Jumping | Climbing | Crouching | Shooting | Rush | Dead,				// Idle
+			Idle | Jumping | Climbing | Crouching | Shooting | Rush | Dead,				// Running
+			Idle | Running | Climbing | Shooting | Dead,									// Jumping: no crouching or rushing in the air
+			Idle | Running | Jumping | Dead,												// Climbing: hands are full until off the ladder
+			Idle | Running | Jumping | Shooting | Dead,									// Crouching
+			Idle | Running | Jumping | Crouching | Dead,									// Shooting
+			Idle | Dead,																	// Rush: an attack runs until it's over
+			0																				// Dead
+		};
+		return (transitions[(size_t)from] & StateBit(to)) != 0;
+	}
+
 public:
-	std::string state = "";
 	CState() {};
-	CState(const std::string& s) : state(s) {}
+	CState(State s) : m_state(s), m_handled(s) {}
+
+	State get() const { return m_state; }
+
+	// Returns true if the state actually changed; same state and illegal transitions are ignored
+	bool set(State next)
+	{
+		if (next == m_state || !canTransition(m_state, next)) { return false; }
+		m_state = next;
+		return true;
+	}
+
+	// True while the state differs from the one sStatus last handled. Setting a state and setting it
+	// back within the same frame doesn't count as a change.
+	bool changed() const { return m_state != m_handled; }
+	void acknowledge() { m_handled = m_state; }
 };
 
 class CTransform : public Component
@@ -191,7 +285,7 @@ public:
 
 	CTransform() {};
 	CTransform(const Vec2& p) :
-		pos(p) {
+		pos(p), prevPos(p) {
 	}
 	CTransform(const Vec2& p, const Vec2& sp, const Vec2& sc, float a) :
 		pos(p), prevPos(p), velocity(sp), scale(sc), angle(a) {
@@ -1,11 +1,14 @@
 #include "Entity.h"
 
-Entity::Entity(const size_t id) :
-	m_id(id)
+Entity::Entity(const size_t id, const uint32_t generation) :
+	m_id(id),
+	m_generation(generation)
 { }
 
 void Entity::destroy()
 {
+	// Destroying through a stale handle must not kill the entity that reused the slot
+	if (!isValid()) { return; }
 	EntityMemoryPool::Instance().destroy(m_id);
 }
 
@@ -14,12 +17,39 @@ const size_t Entity::id() const
 	return m_id;
 }
 
+const uint32_t Entity::generation() const
+{
+	return m_generation;
+}
+
 bool Entity::isActive() const
 {
-	return EntityMemoryPool::Instance().isActive(m_id);
+	return EntityMemoryPool::Instance().isActive(m_id, m_generation);
+}
+
+// True while the slot has not been handed out to another entity since this handle was made.
+// A destroyed entity stays valid (but inactive) until its slot is reused.
+bool Entity::isValid() const
+{
+	return EntityMemoryPool::Instance().getGeneration(m_id) == m_generation;
 }
 
-const std::string& Entity::tag() const
+TagId Entity::tag() const
 {
 	return EntityMemoryPool::Instance().getTag(m_id);
+}
+
+const std::string& Entity::tagName() const
+{
+	return TagRegistry::Instance().getName(tag());
+}
+
+bool Entity::operator == (const Entity& rhs) const
+{
+	return m_id == rhs.m_id && m_generation == rhs.m_generation;
+}
+
+bool Entity::operator != (const Entity& rhs) const
+{
+	return !(*this == rhs);
 }
\ No newline at end of file
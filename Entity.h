@@ -4,6 +4,8 @@
 
 #include <tuple>
 #include <string>
+#include <cassert>
+#include <cstdint>
 
 class EntityMemoryPool;
 
@@ -11,36 +13,47 @@ class Entity
 {
 	friend EntityMemoryPool;
 	size_t		m_id;
+	uint32_t	m_generation;			// Generation of the pool slot this handle was created for
 
-	Entity(const size_t id);
+	Entity(const size_t id, const uint32_t generation);
 public:
 
 	void destroy();
 	const size_t id() const;
+	const uint32_t generation() const;
 	bool isActive() const;
-	const std::string& tag() const;
+	bool isValid() const;
+	TagId tag() const;
+	const std::string& tagName() const;
+
+	bool operator == (const Entity& rhs) const;
+	bool operator != (const Entity& rhs) const;
 
 	template <typename T, typename... TArgs>
 	T& addComponent(TArgs&&... mArgs)
 	{
+		assert(isValid() && "addComponent called on a stale Entity handle");
 		return EntityMemoryPool::Instance().addComponent<T>(m_id, std::forward<TArgs>(mArgs)...);
 	}
 
 	template <typename T>
 	T& getComponent()
 	{
+		assert(isValid() && "getComponent called on a stale Entity handle");
 		return EntityMemoryPool::Instance().getComponent<T>(m_id);
 	}
 
+	// A stale handle never has components, whatever now lives in its old slot
 	template <typename T>
 	bool hasComponent() const
 	{
-		return EntityMemoryPool::Instance().hasComponent<T>(m_id);
+		return isValid() && EntityMemoryPool::Instance().hasComponent<T>(m_id);
 	}
 
 	template <typename T>
-	T& removeComponent()
+	void removeComponent()
 	{
-		return EntityMemoryPool::Instance().removeComponent<T>(m_id);
+		assert(isValid() && "removeComponent called on a stale Entity handle");
+		EntityMemoryPool::Instance().removeComponent<T>(m_id);
 	}
 };
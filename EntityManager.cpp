@@ -1,6 +1,7 @@
 #include "EntityManager.h"
 
 #include <iostream>
+#include <algorithm>
 
 EntityManager::EntityManager() {}
 
@@ -12,19 +13,27 @@ void EntityManager::update()
 	for (auto& e : m_entitiesToAdd)
 	{
 		m_entities.push_back(e);
-		m_entityMap[e.tag()].push_back(e);
+		getTagged(e.tag()).push_back(e);
 	}
 
 	m_entitiesToAdd.clear();
 
-	// Remove dead entities faaom each vector in the entity map
-	// C++17 way of iterating through [key,value] pairs in a map
-	for (auto& [tag, entityVec] : m_entityMap)
+	// Nothing has been destroyed since the last sweep so there is nothing to remove
+	auto& pool = EntityMemoryPool::Instance();
+	if (pool.destroyedCount() == m_lastDestroyedCount) { return; }
+	m_lastDestroyedCount = pool.destroyedCount();
+
+	// Remove dead entities from each tag's vector
+	for (auto& entityVec : m_entityMap)
 	{
-		removeDeadEntities(entityVec);
+		swapRemoveDeadEntities(entityVec);
 	}
 
+	// m_entities is the draw order, so it keeps its order when removing
 	removeDeadEntities(m_entities);
+
+	// No handle to a destroyed entity is left in this manager, the pool can hand those slots out again
+	pool.releaseDestroyed();
 }
 
 void EntityManager::removeDeadEntities(EntityVec& vec)
@@ -41,34 +50,71 @@ void EntityManager::removeDeadEntities(EntityVec& vec)
 	vec.erase(ne, vec.end());
 }
 
-Entity EntityManager::addEntity(const std::string& tag)
+// Order within a tag vector doesn't matter, so move the last entity into the dead one's place
+// instead of shifting everything after it down
+void EntityManager::swapRemoveDeadEntities(EntityVec& vec)
+{
+	size_t i = 0;
+	while (i < vec.size())
+	{
+		if (!vec[i].isActive())
+		{
+			vec[i] = vec.back();
+			vec.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+Entity EntityManager::addEntity(TagId tag)
 {
 	Entity e = EntityMemoryPool::Instance().addEntity(tag);
 	m_entitiesToAdd.push_back(e);
 	return e;
 }
 
+Entity EntityManager::addEntity(const std::string& tag)
+{
+	return addEntity(TagRegistry::Instance().intern(tag));
+}
+
+// Tags can be interned after this manager was created (e.g. while loading a level), grow the list to fit
+EntityVec& EntityManager::getTagged(TagId tag)
+{
+	if (tag >= m_entityMap.size())
+	{
+		m_entityMap.resize(tag + 1);
+	}
+
+	return m_entityMap[tag];
+}
+
 const EntityVec& EntityManager::getEntities()
 {
 	return m_entities;
 }
 
+const EntityVec& EntityManager::getEntities(TagId tag)
+{
+	return getTagged(tag);
+}
+
 const EntityVec& EntityManager::getEntities(const std::string& tag)
 {
-	return m_entityMap[tag];
+	return getTagged(TagRegistry::Instance().intern(tag));
 }
 
-const EntityVec& EntityManager::getEntities(const std::vector<std::string>& tags)
+EntityTagView EntityManager::getEntities(std::initializer_list<TagId> tags)
 {
-	m_tagged.clear();
+	EntityTagView view;
 
-	for (const auto& tag : tags)
+	for (TagId tag : tags)
 	{
-		for (auto& b : m_entityMap[tag])
-		{
-			m_tagged.push_back(b);
-		}
+		view.add(getTagged(tag));
 	}
 
-	return m_tagged;
+	return view;
 }
\ No newline at end of file
@@ -5,30 +5,137 @@
 #include "EntityMemoryPool.h"
 
 #include <vector>
-#include <map>
+#include <deque>
+#include <array>
+#include <cassert>
+#include <initializer_list>
 
 typedef std::vector<Entity> EntityVec;
 
+// Range over an EntityVec that only yields entities whose component signature contains every
+// component in m_signature. Checking the signature is a single read from a packed array, so
+// entities without the components (e.g. static tiles in sMovement) are skipped without touching
+// any component storage.
+class EntityView
+{
+	const EntityVec*	m_entities;
+	ComponentMask		m_signature;
+
+public:
+	class Iterator
+	{
+		EntityVec::const_iterator	m_current;
+		EntityVec::const_iterator	m_end;
+		ComponentMask				m_signature;
+
+		void skipNonMatching()
+		{
+			const auto& pool = EntityMemoryPool::Instance();
+			while (m_current != m_end && !pool.matches(m_current->id(), m_signature))
+			{
+				++m_current;
+			}
+		}
+
+	public:
+		Iterator(EntityVec::const_iterator current, EntityVec::const_iterator end, ComponentMask signature) :
+			m_current(current), m_end(end), m_signature(signature)
+		{
+			skipNonMatching();
+		}
+
+		Entity operator * () const { return *m_current; }
+		Iterator& operator ++ () { ++m_current; skipNonMatching(); return *this; }
+		bool operator != (const Iterator& rhs) const { return m_current != rhs.m_current; }
+	};
+
+	EntityView(const EntityVec& entities, ComponentMask signature) :
+		m_entities(&entities), m_signature(signature) { }
+
+	Iterator begin() const { return Iterator(m_entities->begin(), m_entities->end(), m_signature); }
+	Iterator end() const { return Iterator(m_entities->end(), m_entities->end(), m_signature); }
+};
+
+// Range over several EntityVecs back to back, e.g. every "Tile" followed by every "Destroyable".
+// Only holds pointers to the manager's vectors so iterating it never copies or allocates.
+class EntityTagView
+{
+public:
+	static const size_t MAX_TAGS = 8;
+
+private:
+	std::array<const EntityVec*, MAX_TAGS>	m_vectors = {};
+	size_t									m_count = 0;
+
+public:
+	class Iterator
+	{
+		const EntityTagView*		m_view;
+		size_t						m_vector;
+		size_t						m_index;
+
+		void skipEmpty()
+		{
+			while (m_vector < m_view->m_count && m_index >= m_view->m_vectors[m_vector]->size())
+			{
+				m_vector++;
+				m_index = 0;
+			}
+		}
+
+	public:
+		Iterator(const EntityTagView* view, size_t vector) :
+			m_view(view), m_vector(vector), m_index(0)
+		{
+			skipEmpty();
+		}
+
+		Entity operator * () const { return (*m_view->m_vectors[m_vector])[m_index]; }
+		Iterator& operator ++ () { m_index++; skipEmpty(); return *this; }
+		bool operator != (const Iterator& rhs) const { return m_vector != rhs.m_vector || m_index != rhs.m_index; }
+	};
+
+	void add(const EntityVec& vec)
+	{
+		assert(m_count < MAX_TAGS && "EntityTagView: too many tags in one query");
+		m_vectors[m_count++] = &vec;
+	}
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, m_count); }
+};
+
 class EntityManager
 {
-	EntityVec										m_tagged;					// For returning multiple tags
 	EntityVec										m_entities;					// All entities
 	EntityVec										m_entitiesToAdd;			// Entities to add next update
-	std::map<std::string, EntityVec>				m_entityMap;				// Map from entity tag to vectors
+	std::deque<EntityVec>							m_entityMap;				// Tag id -> entities with that tag (deque so references survive growth)
 	size_t											m_totalEntities = 0;		// Total entities created
+	size_t											m_lastDestroyedCount = 0;	// Pool destroy count at the last dead entity sweep
 
-	// Helper function to avoid repeated code
+	// Helper functions to avoid repeated code
 	void removeDeadEntities(EntityVec& vec);
+	void swapRemoveDeadEntities(EntityVec& vec);
+	EntityVec& getTagged(TagId tag);
 
 public:
 	EntityManager();
 
 	void update();
 
+	Entity addEntity(TagId tag);
 	Entity addEntity(const std::string& tag);
 
 	const EntityVec& getEntities();
+	const EntityVec& getEntities(TagId tag);
 	const EntityVec& getEntities(const std::string& tag);
-	const EntityVec& getEntities(const std::vector<std::string>& tags);
+	EntityTagView getEntities(std::initializer_list<TagId> tags);
+
+	// Entities in this manager that have every listed component, e.g. view<CTransform, CGravity>()
+	template <typename... Ts>
+	EntityView view() const
+	{
+		return EntityView(m_entities, EntityMemoryPool::signatureOf<Ts...>());
+	}
 
 };
\ No newline at end of file
@@ -1,32 +1,55 @@
 #include "EntityMemoryPool.h"
 #include "Entity.h"
 #include <iostream>
+#include <stdexcept>
 
 EntityMemoryPool::EntityMemoryPool(size_t maxEnts) :
 	m_maxEntities(maxEnts)
 {
-	reserveAll(MAX_ENTITIES);
+	reserveAll(m_maxEntities);
 }
 
 void EntityMemoryPool::reserveAll(size_t max)
 {
-	// Allocated memory for every vector using MAX_ENTITIES
-	m_tags.resize(max);
+	// Per-entity bookkeeping is sized up front, component pools grow with the live components
+	m_tags.resize(max, Tag::Default);
 	m_active.resize(max, false);
-	std::apply([max](auto&... vectors) {
-		(..., vectors.resize(max));
-		}, m_pool);
+	m_generations.resize(max, 0);
+	m_signatures.resize(max, 0);
+
+	// Every slot starts out free. Push them in reverse so the lowest indices are handed out first.
+	m_freeIndices.clear();
+	m_freeIndices.reserve(max);
+	for (size_t i = max; i > 0; --i)
+	{
+		m_freeIndices.push_back(i - 1);
+	}
 }
 
 void EntityMemoryPool::destroy(size_t id)
 {
-	// Set all vectors' indices = 0
-	// std::vector<CAnimation>()[index] = 0;
+	// Entities can be destroyed more than once in the same frame (e.g. sLifespan and sAnimation),
+	// only the first call should give the slot back or it would be handed out twice
+	if (!m_active[id]) { return; }
+
 	removeAllComponents(id);
 	m_active[id] = false;
+	m_destroyedIndices.push_back(id);
+	m_numEntities--;
+	m_destroyedCount++;
+}
+
+// Destroyed slots are normally held back until the entity managers have dropped their handles
+// (EntityManager::update), so a system iterating this frame's entity list doesn't see a slot reused mid-frame.
+// The exception is a full pool: getNextEntityIndex then reuses slots destroyed this frame early, and only
+// the generation check (isActive(id, generation)) keeps the old handles to them from reaching the new entity.
+void EntityMemoryPool::releaseDestroyed()
+{
+	m_freeIndices.insert(m_freeIndices.end(), m_destroyedIndices.begin(), m_destroyedIndices.end());
+	m_destroyedIndices.clear();
 }
 
-const std::string& EntityMemoryPool::getTag(size_t id) const
+TagId EntityMemoryPool::getTag(size_t id) const
 {
 	return m_tags[id];
 }
@@ -36,47 +59,77 @@ bool EntityMemoryPool::isActive(size_t id) const
 	return m_active[id];
 }
 
+bool EntityMemoryPool::isActive(size_t id, uint32_t generation) const
+{
+	return m_active[id] && m_generations[id] == generation;
+}
+
+uint32_t EntityMemoryPool::getGeneration(size_t id) const
+{
+	return m_generations[id];
+}
+
 Entity EntityMemoryPool::addEntity(const std::string& tag)
+{
+	return addEntity(TagRegistry::Instance().intern(tag));
+}
+
+Entity EntityMemoryPool::addEntity(TagId tag)
 {
 	size_t index = getNextEntityIndex();
 	m_tags[index] = tag;
 	m_active[index] = true;
-	return Entity(index);
+
+	// Any handle still pointing at the previous occupant of this slot is now stale
+	m_generations[index]++;
+	return Entity(index, m_generations[index]);
 }
 
 size_t EntityMemoryPool::getNextEntityIndex()
 {
-	if (m_numEntities < MAX_ENTITIES)
+	// Out of free slots: reuse ones destroyed this frame rather than fail. Stale handles to them are
+	// caught by their generation, not by waiting for EntityManager::update.
+	if (m_freeIndices.empty())
 	{
-		// We have room to add an entity
-		for (int i = 0; i < MAX_ENTITIES; i++)
-		{
-			// Found an index marked as inactive (we can use this slot)
-			if (!m_active[i])
-			{
-				// We will need to decrement when we call destroy() on an entity
-				m_numEntities++;
-
-				// return inactive index to be used
-				return i;
-			}
-		}
+		releaseDestroyed();
 	}
-	else
+
+	if (m_freeIndices.empty())
 	{
-		// TODO
-		// Handle error here for exceeding max num of entities allowed
-		// but for now do nothing (don't add entity)
-		std::cout << "Max entity count exceeded!!!" << std::endl;
+		// Handing out an active slot would silently overwrite whatever entity lives there
+		throw std::length_error("EntityMemoryPool: max entity count (" + std::to_string(m_maxEntities) + ") exceeded");
 	}
 
-	return 0;
+	// Pop the most recently freed slot, it is the most likely to still be in cache
+	size_t index = m_freeIndices.back();
+	m_freeIndices.pop_back();
+	m_numEntities++;
+
+	return index;
+}
+
+// Entity managers compare this against the value they last saw to know if anything died since
+size_t EntityMemoryPool::destroyedCount() const
+{
+	return m_destroyedCount;
+}
+
+size_t EntityMemoryPool::size() const
+{
+	return m_numEntities;
+}
+
+size_t EntityMemoryPool::capacity() const
+{
+	return m_maxEntities;
 }
 
 void EntityMemoryPool::removeAllComponents(size_t entityId)
 {
-	std::apply([&](auto&... componentVectors)
+	std::apply([&](auto&... componentPools)
 		{
-			(..., (componentVectors[entityId].has = false));
+			(..., componentPools.remove(entityId));
 		}, m_pool);
+
+	m_signatures[entityId] = 0;
 }
\ No newline at end of file
@@ -1,41 +1,70 @@
 #pragma once
 
 #include "Components.h"
+#include "ComponentPool.h"
+#include "Tags.h"
 //#include "Entity.h"
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <tuple>
 
 static const size_t MAX_ENTITIES = 100000;
 
 typedef std::tuple<
-	std::vector<CAnimation>,
-	std::vector<CAttacking>,
-	std::vector<CBoundingBox>,
-	std::vector<CClimbable>,
-	std::vector<CDamage>,
-	std::vector<CDestroyable>,
-	std::vector<CDraggable>,
-	std::vector<CEnemyType>,
-	std::vector<CGravity>,
-	std::vector<CGridLocation>,
-	std::vector<CHealth>,
-	std::vector<CInput>,
-	std::vector<CInvulnerable>,
-	std::vector<CLifespan>,
-	std::vector<CRayCaster>,
-	std::vector<CState>,
-	std::vector<CTransform>> EntityComponentVectorTuple;
+	ComponentPool<CAnimation>,
+	ComponentPool<CAttacking>,
+	ComponentPool<CBoundingBox>,
+	ComponentPool<CClimbable>,
+	ComponentPool<CDamage>,
+	ComponentPool<CDestroyable>,
+	ComponentPool<CDraggable>,
+	ComponentPool<CEnemyType>,
+	ComponentPool<CGravity>,
+	ComponentPool<CGridLocation>,
+	ComponentPool<CHealth>,
+	ComponentPool<CInput>,
+	ComponentPool<CInvulnerable>,
+	ComponentPool<CLifespan>,
+	ComponentPool<CRayCaster>,
+	ComponentPool<CState>,
+	ComponentPool<CTransform>> EntityComponentPoolTuple;
+
+// One bit per component type, in the order of EntityComponentPoolTuple
+typedef uint32_t ComponentMask;
+
+template <typename T, typename Tuple>
+struct ComponentIndex;
+
+template <typename T, typename... Rest>
+struct ComponentIndex<T, std::tuple<ComponentPool<T>, Rest...>>
+{
+	static constexpr size_t value = 0;
+};
+
+template <typename T, typename First, typename... Rest>
+struct ComponentIndex<T, std::tuple<First, Rest...>>
+{
+	static constexpr size_t value = 1 + ComponentIndex<T, std::tuple<Rest...>>::value;
+};
+
+static_assert(std::tuple_size<EntityComponentPoolTuple>::value <= sizeof(ComponentMask) * 8, "ComponentMask has too few bits for every component type");
 
 class Entity;
 
 class EntityMemoryPool
 {
 	size_t							m_numEntities = 0;
+	size_t							m_destroyedCount = 0;		// Total destroy() calls that freed a slot, never reset
 	const size_t					m_maxEntities;
-	EntityComponentVectorTuple		m_pool;
-	std::vector<std::string>		m_tags;
+	EntityComponentPoolTuple		m_pool;
+	std::vector<TagId>				m_tags;
 	std::vector<bool>				m_active;
+	std::vector<uint32_t>			m_generations;				// Bumped every time a slot is handed out, used to detect stale handles
+	std::vector<ComponentMask>		m_signatures;				// Which components each entity currently has
+	std::vector<size_t>				m_freeIndices;				// Stack of inactive slots, next slot to hand out is at the back
+	std::vector<size_t>				m_destroyedIndices;			// Slots destroyed since the last releaseDestroyed()
 
 	EntityMemoryPool(size_t maxEntities);
 	void reserveAll(size_t maxEntities);
@@ -43,11 +72,18 @@ class EntityMemoryPool
 
 public:
 
-	const std::string& getTag(size_t entityId) const;
+	TagId getTag(size_t entityId) const;
 	bool isActive(size_t entityId) const;
+	bool isActive(size_t entityId, uint32_t generation) const;
+	uint32_t getGeneration(size_t entityId) const;
 	void destroy(size_t entityId);
 	size_t getNextEntityIndex();
+	void releaseDestroyed();
+	size_t destroyedCount() const;
+	Entity addEntity(TagId tag);
 	Entity addEntity(const std::string& tag);
+	size_t size() const;
+	size_t capacity() const;
 
 	static EntityMemoryPool& Instance()
 	{
@@ -56,35 +92,52 @@ public:
 	}
 
 	template <typename T>
-	T& getComponent(size_t id)
+	static constexpr ComponentMask componentBit()
+	{
+		return ComponentMask(1) << ComponentIndex<T, EntityComponentPoolTuple>::value;
+	}
+
+	template <typename... Ts>
+	static constexpr ComponentMask signatureOf()
 	{
-		return std::get<std::vector<T>>(m_pool)[id];
+		return (ComponentMask(0) | ... | componentBit<Ts>());
 	}
 
-	//template <typename T>
-	//const T& getComponent(size_t id) const
-	//{
-	//	return std::get<std::vector<T>>(m_pool)[id];
-	//}
+	// True if the entity has every component in the signature
+	bool matches(size_t id, ComponentMask signature) const
+	{
+		return (m_signatures[id] & signature) == signature;
+	}
+
+	template <typename T>
+	ComponentPool<T>& getComponentPool()
+	{
+		return std::get<ComponentPool<T>>(m_pool);
+	}
+
+	template <typename T>
+	T& getComponent(size_t id)
+	{
+		return getComponentPool<T>().get(id);
+	}
 
 	template <typename T>
 	bool hasComponent(size_t id)
 	{
-		return std::get<std::vector<T>>(m_pool)[id].has;
+		return (m_signatures[id] & componentBit<T>()) != 0;
 	}
 
 	template <typename T, typename... TArgs>
 	T& addComponent(size_t id, TArgs&&... mArgs)
 	{
-		auto& component = getComponent<T>(id);
-		component = T(std::forward<TArgs>(mArgs)...);
-		component.has = true;
-		return component;
+		m_signatures[id] |= componentBit<T>();
+		return getComponentPool<T>().add(id, std::forward<TArgs>(mArgs)...);
 	}
 
 	template <typename T>
 	void removeComponent(size_t id)
 	{
-		getComponent<T>(id) = T(id);
+		m_signatures[id] &= ~componentBit<T>();
+		getComponentPool<T>().remove(id);
 	}
 };
\ No newline at end of file
@@ -1,24 +1,30 @@
-#include "Scene_Menu.h"
+#include "Scene_Loading.h"
+#include "Scene_Play.h"
 #include "GameEngine.h"
+#include "Profiler.h"
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <cmath>
 
 GameEngine::GameEngine(const std::string& path)
 {
 	init(path);
 }
 
+GameEngine::GameEngine(const std::string& path, const HeadlessSettings& headless) :
+	m_headless(true),
+	m_headlessSettings(headless)
+{
+	init(path);
+}
+
 void GameEngine::init(const std::string& path)
 {
-	if (m_assets.loadFromFile(path))
-	{
-		std::cout << "Assets loaded from " << path << " successfully.\n";
-	}
-	else
-	{
-		std::cerr << "Assets failed to load.";
-	}
+	// Nothing is ever drawn headless, so the atlas pages don't need to go to the GPU (which
+	// build servers may not have). Animations still get their sizes and frame rects.
+	m_assets.setUploadTextures(!m_headless);
 
 	std::cout << "Attempting to read in 'config.txt' now.\n";
 	std::ifstream file("config.txt");
@@ -39,13 +45,45 @@ void GameEngine::init(const std::string& path)
 			{
 				file >> wWidth >> wHeight >> m_fps;
 			}
+			else if (str == "Simulation")
+			{
+				file >> m_tickRate >> m_maxCatchUpTicks;
+			}
 		}
 	}
 
+	if (m_tickRate <= 0) { m_tickRate = 60; }
+	if (m_maxCatchUpTicks == 0) { m_maxCatchUpTicks = 1; }
+
+	m_windowSize = { wWidth, wHeight };
+	m_view = sf::View(sf::FloatRect({ 0, 0 }, { (float)wWidth, (float)wHeight }));
+
+	// There's nothing to show headless, so just wait for the assets. The level is loaded by runHeadless.
+	if (m_headless)
+	{
+		if (m_assets.loadFromFile(path))
+		{
+			std::cout << "Assets loaded from " << path << " successfully.\n";
+		}
+		else
+		{
+			std::cerr << "Assets failed to load.";
+		}
+		return;
+	}
+
 	m_window.create(sf::VideoMode({ wWidth, wHeight }), "Sad Guy");
 	m_window.setFramerateLimit(m_fps);
+	m_window.setView(m_view);
+
+	// Images and sounds decode in the background while the loading scene draws progress, it moves on to the menu when they're in
+	if (!m_assets.beginLoading(path))
+	{
+		std::cerr << "Assets failed to load.";
+	}
 
-	changeScene("MENU", std::make_shared<Scene_Menu>(this));
+	changeScene("LOADING", std::make_shared<Scene_Loading>(this));
+	m_frameClock.restart();
 }
 
 std::shared_ptr<Scene> GameEngine::currentScene()
@@ -55,7 +93,7 @@ std::shared_ptr<Scene> GameEngine::currentScene()
 
 bool GameEngine::isRunning()
 {
-	return m_running && m_window.isOpen();
+	return m_running && (m_headless || m_window.isOpen());
 }
 
 sf::RenderWindow& GameEngine::window()
@@ -63,12 +101,133 @@ sf::RenderWindow& GameEngine::window()
 	return m_window;
 }
 
+// Size of the game's viewport. Scenes should use this over window().getSize() so they work headless.
+const sf::Vector2u& GameEngine::windowSize() const
+{
+	return m_windowSize;
+}
+
+const sf::View& GameEngine::view() const
+{
+	return m_view;
+}
+
+void GameEngine::setView(const sf::View& view)
+{
+	m_view = view;
+	if (!m_headless) { m_window.setView(view); }
+}
+
+bool GameEngine::isHeadless() const
+{
+	return m_headless;
+}
+
+const std::string& GameEngine::recordPath() const
+{
+	return m_recordPath;
+}
+
+// Call before run(). Every play scene started afterwards records its actions to path, overwriting the last one.
+void GameEngine::setRecordPath(const std::string& path)
+{
+	m_recordPath = path;
+}
+
+// Non zero when a headless replay didn't reproduce its recording
+int GameEngine::exitCode() const
+{
+	return m_exitCode;
+}
+
+int GameEngine::tickRate() const
+{
+	return m_tickRate;
+}
+
 void GameEngine::run()
 {
+	if (m_headless)
+	{
+		runHeadless();
+		return;
+	}
+
 	while (isRunning())
 	{
 		update();
 	}
+
+	// Closing the window mid level still leaves a usable recording
+	if (!m_sceneMap.empty()) { currentScene()->stopRecording(); }
+}
+
+// Simulates the level tick after tick with no frame pacing, input or rendering, then reports how fast it went
+void GameEngine::runHeadless()
+{
+	HeadlessSettings& settings = m_headlessSettings;
+	bool replaying = !settings.replayPath.empty();
+
+	if (replaying)
+	{
+		if (!m_replay.loadFromFile(settings.replayPath)) { m_exitCode = 1; return; }
+
+		if (settings.levelPath.empty()) { settings.levelPath = m_replay.levelPath(); }
+		else if (settings.levelPath != m_replay.levelPath())
+		{
+			std::cerr << "Warning: replaying a recording of " << m_replay.levelPath() << " on " << settings.levelPath << "\n";
+		}
+		if (m_replay.tickRate() != m_tickRate)
+		{
+			std::cerr << "Warning: recorded at " << m_replay.tickRate() << " ticks/s but simulating at " << m_tickRate << "\n";
+		}
+	}
+	else if (!settings.inputPath.empty())
+	{
+		// A run that silently plays without its input would pass while testing nothing
+		if (!m_inputScript.loadFromFile(settings.inputPath)) { m_exitCode = 1; return; }
+	}
+
+	if (settings.levelPath.empty())
+	{
+		std::cerr << "No level to run headless.\n";
+		m_exitCode = 1;
+		return;
+	}
+
+	// A replay that ended normally stopped after endTick() ticks, otherwise give its last action a tick to take effect
+	size_t ticks = settings.ticks;
+	if (ticks == 0) { ticks = replaying ? m_replay.lastTick() + (m_replay.hasEnd() ? 0 : 1) : 60 * 60; }
+
+	changeScene("PLAY", std::make_shared<Scene_Play>(this, settings.levelPath));
+	auto scene = currentScene();
+
+	auto start = std::chrono::steady_clock::now();
+
+	while (isRunning() && scene->tick() < ticks && !scene->hasEnded())
+	{
+		if (replaying) { m_replay.dispatch(scene->tick(), *scene); }
+		else { m_inputScript.dispatch(scene->tick(), *scene); }
+
+		// The recording may end the scene (QUIT) on the tick it was stopped on
+		if (scene->hasEnded()) { break; }
+		scene->simulate(1);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	size_t tick = scene->tick();
+	std::cout << "Headless run of " << settings.levelPath << ": " << tick << " ticks in " << seconds << "s ("
+		<< (seconds > 0 ? tick / seconds : 0.0) << " ticks/s, " << (seconds > 0 ? tick / seconds / m_tickRate : 0.0) << "x real time)\n";
+
+	if (replaying && m_replay.hasEnd() && settings.ticks == 0)
+	{
+		bool match = tick == m_replay.endTick() && scene->stateChecksum() == m_replay.checksum();
+		std::cout << "Replay " << (match ? "matches" : "DIVERGED from") << " the recording (tick " << tick << " of " << m_replay.endTick()
+			<< ", checksum " << std::hex << scene->stateChecksum() << " vs " << m_replay.checksum() << std::dec << ")\n";
+		if (!match) { m_exitCode = 1; }
+	}
+
+	scene->stopRecording();
 }
 
 void GameEngine::sUserInput()
@@ -108,6 +267,19 @@ void GameEngine::sUserInput()
 					}
 				}
 
+				if (event->getIf<sf::Event::KeyPressed>()->code == sf::Keyboard::Key::F4)
+				{
+					// Start or stop writing a trace of the PROFILE_SCOPEs
+					if (Profiler::Instance().isCapturing()) { Profiler::Instance().stopCapture(); }
+					else
+					{
+#ifndef PROFILING
+						std::cerr << "Built without PROFILING, the trace will be empty.\n";
+#endif
+						Profiler::Instance().startCapture("results.json");
+					}
+				}
+
 				// If the current scene does not have an action associated with this key, skip the event
 				if (currentScene()->getActionMap().find(event->getIf<sf::Event::KeyPressed>()->code) == currentScene()->getActionMap().end())
 				{
@@ -220,23 +392,49 @@ const Assets& GameEngine::assets() const
 	return m_assets;
 }
 
+Assets& GameEngine::assets()
+{
+	return m_assets;
+}
+
 void GameEngine::update()
 {
 	if (!isRunning()) { return; }
 	if (m_sceneMap.empty()) { return; }
 
 	sUserInput();
-	currentScene()->simulate(m_simulationSpeed);
+
+	// Simulate in fixed steps of 1 / m_tickRate seconds for however much real time has passed, so game speed
+	// doesn't depend on the frame rate. After a long stall only m_maxCatchUpTicks are run and the rest of the
+	// backlog is dropped, instead of the game fast forwarding to catch up.
+	const float tickTime = 1.0f / m_tickRate;
+	m_accumulator += m_frameClock.restart().asSeconds() * m_simulationSpeed;
+
+	size_t ticks = 0;
+	while (m_accumulator >= tickTime && ticks < m_maxCatchUpTicks)
+	{
+		currentScene()->simulate(1);
+		m_accumulator -= tickTime;
+		ticks++;
+	}
+
+	if (m_accumulator >= tickTime)
+	{
+		m_accumulator = std::fmod(m_accumulator, tickTime);
+	}
 
 	// Render system is separated from the scene update so the game engine can
-	// simulate a specified number of frames without rendering each frame of simulation
-	//currentScene()->sRender();
+	// simulate a specified number of frames without rendering each frame of simulation.
+	// Whatever time is left over is drawn as a blend between the last two ticks.
+	currentScene()->setInterpolation(m_accumulator / tickTime);
 	currentScene()->sRender();
 	m_window.display();
 }
 
 void GameEngine::playSound(const std::string& soundName)
 {
+	if (m_headless) { return; }
+
 	if (soundName.find("Music") != std::string::npos)
 	{
 		if (!m_music.openFromFile(this->assets().getMusic(soundName)))
@@ -254,6 +452,8 @@ void GameEngine::playSound(const std::string& soundName)
 
 void GameEngine::stopSound(const std::string& soundName)
 {
+	if (m_headless) { return; }
+
 	if (soundName.find("Music") != std::string::npos)
 	{
 		m_music.stop();
@@ -2,26 +2,50 @@
 
 #include "Scene.h"
 #include "Assets.h"
+#include "InputScript.h"
+#include "ActionReplay.h"
 
 #include <memory>
 
 typedef std::map<std::string, std::shared_ptr<Scene>> SceneMap;
 
+// Runs one level as fast as possible with no window, fed by an input script or a recording, for batch play-throughs
+struct HeadlessSettings
+{
+	std::string		levelPath;					// Optional with a replay, which knows its level
+	std::string		inputPath;					// Optional, the player stands still without one
+	std::string		replayPath;					// Optional, an ActionRecorder file to play back
+	size_t			ticks = 0;					// Ticks to simulate before stopping, 0 for all of the replay or a minute without one
+};
+
 class GameEngine
 {
 
 protected:
 	sf::RenderWindow		m_window;
+	sf::Vector2u			m_windowSize;				// Viewport size, also valid when there is no window
+	sf::View				m_view;						// Camera the simulation works with
+	bool					m_headless = false;
+	HeadlessSettings		m_headlessSettings;
+	InputScript				m_inputScript;
+	ActionReplay			m_replay;
+	std::string				m_recordPath;				// Play scenes record their actions here when set
 	Assets					m_assets;
 	std::string				m_currentScene;
 	SceneMap				m_sceneMap;
 	size_t					m_simulationSpeed = 1;
+	int						m_tickRate = 60;			// Simulation ticks per second, independent of the frame rate
+	size_t					m_maxCatchUpTicks = 5;		// Most ticks simulated for one rendered frame
+	sf::Clock				m_frameClock;
+	float					m_accumulator = 0;			// Real time not yet simulated, in seconds
 	bool					m_running = true;
+	int						m_exitCode = 0;
 	int						m_fps = 60;
 	sf::Music				m_music;
 
 	void init(const std::string& path);
 	void update();
+	void runHeadless();
 
 	void sUserInput();
 
@@ -30,9 +54,11 @@ protected:
 public:
 
 	GameEngine(const std::string& path);
+	GameEngine(const std::string& path, const HeadlessSettings& headless);
 
 	void changeScene(const std::string& sceneName, std::shared_ptr<Scene> scene, bool endCurrentScene = false);
 
+	void setRecordPath(const std::string& path);
 	void quit();
 	void run();
 
@@ -40,7 +66,15 @@ public:
 	void stopSound(const std::string& soundName);
 
 	sf::RenderWindow& window();
+	const sf::Vector2u& windowSize() const;
+	const sf::View& view() const;
+	void setView(const sf::View& view);
+	bool isHeadless() const;
+	const std::string& recordPath() const;
+	int tickRate() const;
+	int exitCode() const;
 	const Assets& assets() const;
+	Assets& assets();
 	bool isRunning();
 	const int getFps() const;
 };
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "GridOverlay.h"
+
+#include <cmath>
+
+GridOverlay::GridOverlay(const sf::Font& font, const Vec2& gridSize, unsigned int characterSize) :
+	m_font(&font),
+	m_characterSize(characterSize),
+	m_gridSize(gridSize)
+{
+
+}
+
+// Lays the glyphs out the same way sf::Text does, with the top of the text at y
+void GridOverlay::addLabel(const std::string& text, float x, float y)
+{
+	float baseline = y + m_characterSize;
+	for (char c : text)
+	{
+		const sf::Glyph& glyph = m_font->getGlyph((unsigned char)c, m_characterSize, false);
+
+		float left = x + glyph.bounds.position.x;
+		float top = baseline + glyph.bounds.position.y;
+		float right = left + glyph.bounds.size.x;
+		float bottom = top + glyph.bounds.size.y;
+
+		float u0 = (float)glyph.textureRect.position.x;
+		float v0 = (float)glyph.textureRect.position.y;
+		float u1 = u0 + glyph.textureRect.size.x;
+		float v1 = v0 + glyph.textureRect.size.y;
+
+		m_labels.append(sf::Vertex{ { left, top }, sf::Color::White, { u0, v0 } });
+		m_labels.append(sf::Vertex{ { right, top }, sf::Color::White, { u1, v0 } });
+		m_labels.append(sf::Vertex{ { left, bottom }, sf::Color::White, { u0, v1 } });
+		m_labels.append(sf::Vertex{ { left, bottom }, sf::Color::White, { u0, v1 } });
+		m_labels.append(sf::Vertex{ { right, top }, sf::Color::White, { u1, v0 } });
+		m_labels.append(sf::Vertex{ { right, bottom }, sf::Color::White, { u1, v1 } });
+
+		x += glyph.advance;
+	}
+}
+
+void GridOverlay::rebuild(int firstColumn, int lastColumn, int firstRow, int lastRow)
+{
+	m_lines.clear();
+	m_labels.clear();
+
+	float left = firstColumn * m_gridSize.x;
+	float right = (lastColumn + 1) * m_gridSize.x;
+	float top = m_groundY - (lastRow + 1) * m_gridSize.y;
+	float bottom = m_groundY - firstRow * m_gridSize.y;
+
+	for (int column = firstColumn; column <= lastColumn + 1; ++column)
+	{
+		float x = column * m_gridSize.x;
+		m_lines.append(sf::Vertex{ { x, top } });
+		m_lines.append(sf::Vertex{ { x, bottom } });
+	}
+
+	for (int row = firstRow; row <= lastRow + 1; ++row)
+	{
+		float y = m_groundY - row * m_gridSize.y;
+		m_lines.append(sf::Vertex{ { left, y } });
+		m_lines.append(sf::Vertex{ { right, y } });
+	}
+
+	for (int row = firstRow; row <= lastRow; ++row)
+	{
+		float cellTop = m_groundY - (row + 1) * m_gridSize.y;
+		for (int column = firstColumn; column <= lastColumn; ++column)
+		{
+			addLabel("(" + std::to_string(column) + "," + std::to_string(row) + ")", column * m_gridSize.x + 3, cellTop + 2);
+		}
+	}
+}
+
+void GridOverlay::draw(sf::RenderTarget& target, float groundY)
+{
+	const sf::View& view = target.getView();
+	Vec2 viewSize(view.getSize().x, view.getSize().y);
+	float left = view.getCenter().x - viewSize.x / 2;
+	float top = view.getCenter().y - viewSize.y / 2;
+
+	// One extra column and row so the cached grid still covers the view anywhere inside the first cell
+	int firstColumn = (int)std::floor(left / m_gridSize.x);
+	int lastColumn = firstColumn + (int)std::ceil(viewSize.x / m_gridSize.x);
+	int firstRow = (int)std::floor((groundY - (top + viewSize.y)) / m_gridSize.y);
+	int lastRow = firstRow + (int)std::ceil(viewSize.y / m_gridSize.y);
+
+	if (!m_built || firstColumn != m_firstColumn || firstRow != m_firstRow || viewSize != m_viewSize || groundY != m_groundY)
+	{
+		m_firstColumn = firstColumn;
+		m_firstRow = firstRow;
+		m_viewSize = viewSize;
+		m_groundY = groundY;
+		m_built = true;
+		rebuild(firstColumn, lastColumn, firstRow, lastRow);
+	}
+
+	target.draw(m_lines);
+	target.draw(m_labels, sf::RenderStates(&m_font->getTexture(m_characterSize)));
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Vec2.h"
+
+#include <SFML/Graphics.hpp>
+#include <string>
+
+// The debug grid (G key) with a "(x,y)" label in every cell. Lines and labels are built into two vertex
+// arrays - one for the lines and one holding the label glyphs from the font's texture - and reused until
+// the camera crosses into a different cell, so a visible grid costs two draw calls per frame.
+class GridOverlay
+{
+	const sf::Font*		m_font = nullptr;
+	unsigned int		m_characterSize = 24;
+	Vec2				m_gridSize = { 64, 64 };
+	sf::VertexArray		m_lines = sf::VertexArray(sf::PrimitiveType::Lines);
+	sf::VertexArray		m_labels = sf::VertexArray(sf::PrimitiveType::Triangles);
+
+	// What the cached arrays were built for
+	bool				m_built = false;
+	int					m_firstColumn = 0;
+	int					m_firstRow = 0;
+	Vec2				m_viewSize;
+	float				m_groundY = 0;
+
+	void rebuild(int firstColumn, int lastColumn, int firstRow, int lastRow);
+	void addLabel(const std::string& text, float x, float y);
+
+public:
+	GridOverlay(const sf::Font& font, const Vec2& gridSize, unsigned int characterSize);
+
+	// Rows are counted up from groundY, the world y of the bottom of row 0
+	void draw(sf::RenderTarget& target, float groundY);
+};
@@ -0,0 +1,82 @@
+#include "InputScript.h"
+#include "Scene.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool InputScript::loadFromFile(const std::string& path)
+{
+	std::ifstream fin(path);
+	if (!fin.is_open())
+	{
+		std::cerr << "Could not open input script: " << path << std::endl;
+		return false;
+	}
+
+	m_actions.clear();
+	m_next = 0;
+
+	std::string line;
+	size_t lineNumber = 0;
+	while (std::getline(fin, line))
+	{
+		lineNumber++;
+		std::stringstream ss(line);
+		std::string name, type;
+		size_t tick = 0;
+
+		if (!(ss >> name) || name[0] == '#') { continue; }
+
+		// The first token was the tick
+		std::stringstream tickStream(name);
+		if (!(tickStream >> tick) || !(ss >> name >> type) || (type != "START" && type != "END"))
+		{
+			std::cerr << path << ":" << lineNumber << ": expected <tick> <ACTION_NAME> <START|END> [x y]" << std::endl;
+			continue;
+		}
+
+		Vec2 pos;
+		ss >> pos.x >> pos.y;
+		m_actions.push_back({ tick, Action(name, type, pos) });
+	}
+
+	// Stable so actions on the same tick keep the order they were written in
+	std::stable_sort(m_actions.begin(), m_actions.end(), [](const ScriptedAction& a, const ScriptedAction& b)
+	{
+		return a.tick < b.tick;
+	});
+
+	return true;
+}
+
+// Sends every action due on or before tick that hasn't been sent yet
+void InputScript::dispatch(size_t tick, Scene& scene)
+{
+	while (m_next < m_actions.size() && m_actions[m_next].tick <= tick)
+	{
+		scene.doAction(m_actions[m_next].action);
+		m_next++;
+	}
+}
+
+void InputScript::rewind()
+{
+	m_next = 0;
+}
+
+bool InputScript::finished() const
+{
+	return m_next >= m_actions.size();
+}
+
+size_t InputScript::lastTick() const
+{
+	return m_actions.empty() ? 0 : m_actions.back().tick;
+}
+
+size_t InputScript::size() const
+{
+	return m_actions.size();
+}
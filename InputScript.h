@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Action.h"
+
+#include <string>
+#include <vector>
+
+class Scene;
+
+// Actions to send to a scene on given simulation ticks, read from a text file so a scene can be
+// played without a keyboard. Each line is "<tick> <ACTION_NAME> <START|END> [x y]", and lines
+// starting with # are comments, e.g.
+//		0	RIGHT	START
+//		45	JUMP	START
+//		50	JUMP	END
+class InputScript
+{
+	struct ScriptedAction
+	{
+		size_t		tick = 0;
+		Action		action;
+	};
+
+	std::vector<ScriptedAction>		m_actions;			// Sorted by tick
+	size_t							m_next = 0;			// First action not sent yet
+
+public:
+	InputScript() {}
+
+	bool loadFromFile(const std::string& path);
+	void dispatch(size_t tick, Scene& scene);
+	void rewind();
+
+	bool finished() const;
+	size_t lastTick() const;
+	size_t size() const;
+};
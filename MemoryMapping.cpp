@@ -2,21 +2,32 @@
 
 #include <iostream>
 
-MemoryMapping::MemoryMapping()
-{
-
-}
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 MemoryMapping::MemoryMapping(const std::string& filename)
 {
 	if (!open(filename)) { close(); }
 }
 
+MemoryMapping::~MemoryMapping()
+{
+	close();
+}
+
+#ifdef _WIN32
+
 bool MemoryMapping::open(const std::string& filename)
 {
 	// Create the file handle to the specified file so a process has a way to identify the file.
 	// For the usage in this program, only reading a file is needed.
-	m_hFile = ::CreateFileA(
+	HANDLE hFile = ::CreateFileA(
 		filename.c_str(),         // name of file
 		GENERIC_READ,             // requested access mode of read. must have the same access of the file mapping object
 		0,                        // prevent processes from sharing and prevent the file from being opened again until the handle is closed
@@ -24,22 +35,32 @@ bool MemoryMapping::open(const std::string& filename)
 		OPEN_EXISTING,            // only open existing files and will throw an error if a file doesn't exist
 		FILE_ATTRIBUTE_READONLY,  // only allow the file to be read
 		NULL);                    // template file parameter ignored when opening an existing file
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		std::cerr << "ERROR: couldn't open " << filename << ".\n";
+		return false;
+	}
+	m_hFile = hFile;
 
 	// Get the point to the structure that will stores the file size in bytes
 	LARGE_INTEGER result;
-	if (!GetFileSizeEx(m_hFile, &result))
+	if (!GetFileSizeEx(hFile, &result))
 	{
 		std::cerr << "ERROR: couldn't get file size.\n";
 		return false;
 	}
+	m_size = static_cast<size_t>(result.QuadPart);
 
-	// The compiler supports 64-bit integers so grab the 64-bit filesize integer from the structure
-	uint64_t filesize = 0;
-	filesize = static_cast<uint64_t>(result.QuadPart);
+	// An empty file can't be mapped, but it's still a file with nothing in it
+	if (m_size == 0)
+	{
+		m_isOpen = true;
+		return true;
+	}
 
 	// Create the file mapping object
 	m_hFileMapping = ::CreateFileMapping(
-		m_hFile,                  // name of the file handle
+		hFile,                    // name of the file handle
 		NULL,                     // no security attributes being used
 		PAGE_READONLY,            // set read only for views and the file handle must be set to read access rights
 		0,						  // a value of zero for this and the next argument sets the maximum size of the
@@ -51,58 +72,107 @@ bool MemoryMapping::open(const std::string& filename)
 		return false;
 	}
 
-	// Setup of parameters for the part of the file to be set in the view.
+	// Map a view of the whole file
+	m_data = static_cast<const char*>(::MapViewOfFile(
+		m_hFileMapping,          // name of the file mapping object
+		FILE_MAP_READ,           // the requested access of read which the file mapping object must have the same access status
+		0,                       // this and the next argument specify where the view begins in the file
+		0,
+		m_size));                // the number of bytes of the file to be mapped to the view
+	if (m_data == NULL)
+	{
+		std::cerr << "ERROR: Failed creating the map view of the file.\n";
+		return false;
+	}
+
+	m_isOpen = true;
+	return true;
+}
+
+void MemoryMapping::close()
+{
+	// must clean up the resources in reverse order of their creation
+	// and zero out the memory address they were located at
+	if (m_data) { ::UnmapViewOfFile(m_data); }
+	m_data = nullptr;
+	if (m_hFileMapping) { ::CloseHandle(m_hFileMapping); }
+	m_hFileMapping = nullptr;
+	if (m_hFile) { ::CloseHandle(m_hFile); }
+	m_hFile = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
 
-	// The offset is where the view should begin in the file and it has to be a 
-	// multiple of the allocation granularity of the system.
-	uint64_t offset = 0;
+#else
 
-	// The number of bytes of the file that is to be mapped to the view.
-	size_t mappedBytes = 0;
-	if (offset > filesize)
+bool MemoryMapping::open(const std::string& filename)
+{
+	m_fd = ::open(filename.c_str(), O_RDONLY);
+	if (m_fd < 0)
 	{
-		std::cerr << "ERROR: Outside of the end of the file.\n";
+		std::cerr << "ERROR: couldn't open " << filename << ".\n";
 		return false;
 	}
 
-	// Set the number of bytes to be mapped to the amount of bytes in the file if mappedBytes becomes larger than the file size.
-	if (offset + mappedBytes > filesize)
+	struct stat info;
+	if (::fstat(m_fd, &info) != 0)
 	{
-		mappedBytes = size_t(filesize - offset);
+		std::cerr << "ERROR: couldn't get file size.\n";
+		return false;
 	}
+	m_size = static_cast<size_t>(info.st_size);
 
-	DWORD offsetLow = DWORD(offset & 0xFFFFFFFF);
-	DWORD offsetHigh = DWORD(offset >> 32);
+	// mmap refuses zero length mappings, but an empty file is still a file with nothing in it
+	if (m_size == 0)
+	{
+		m_isOpen = true;
+		return true;
+	}
 
-	// Map a view of the file
-	m_mapViewOfFile = ::MapViewOfFile(
-		m_hFileMapping,          // name of the file mapping object
-		FILE_MAP_READ,           // the requested access of read which the file mapping object must have the same access status
-		offsetHigh,              // this and the next argument specify where the view begins in the file
-		offsetLow,
-		mappedBytes);            // the number of bytes of the file to be mapped to the view
-	if (m_mapViewOfFile == NULL)
+	void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+	if (data == MAP_FAILED)
 	{
-		std::cerr << "ERROR: Failed creating the map view of the file.\n";
+		std::cerr << "ERROR: Failed to map " << filename << " into memory.\n";
 		return false;
 	}
+	m_data = static_cast<const char*>(data);
+
+	// The parsers read front to back
+	::madvise(data, m_size, MADV_SEQUENTIAL);
 
+	m_isOpen = true;
 	return true;
 }
 
 void MemoryMapping::close()
 {
-	// must clean up the resources in reverse order of their creation
-	// and zero out the memory address they were located at
-	::UnmapViewOfFile(m_mapViewOfFile);
-	m_mapViewOfFile = nullptr;
-	::CloseHandle(m_hFileMapping);
-	m_hFileMapping = NULL;
-	::CloseHandle(m_hFile);
-	m_hFile = NULL;
+	if (m_data) { ::munmap(const_cast<char*>(m_data), m_size); }
+	m_data = nullptr;
+	if (m_fd >= 0) { ::close(m_fd); }
+	m_fd = -1;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+#endif
+
+const char* MemoryMapping::data() const
+{
+	return m_data;
+}
+
+size_t MemoryMapping::size() const
+{
+	return m_size;
+}
+
+// The whole file, empty if it couldn't be opened
+std::string_view MemoryMapping::view() const
+{
+	return m_data ? std::string_view(m_data, m_size) : std::string_view();
 }
 
-char* MemoryMapping::getData()
+bool MemoryMapping::isOpen() const
 {
-	return static_cast<char*>(m_mapViewOfFile);
-}
\ No newline at end of file
+	return m_isOpen;
+}
@@ -1,22 +1,37 @@
 #pragma once
 
-#include <windows.h>
+#include <cstddef>
 #include <string>
+#include <string_view>
 
+// Read only view of a whole file mapped into memory, so parsers can read it in place without copying it.
+// Uses CreateFileMapping/MapViewOfFile on Windows and mmap everywhere else.
+// The data is NOT null terminated - always use it together with size().
 class MemoryMapping
 {
-	HANDLE		m_hFile = NULL;
-	HANDLE		m_hFileMapping = NULL;
-	void* m_mapViewOfFile = nullptr;
-
-	MemoryMapping();
+#ifdef _WIN32
+	void*		m_hFile = nullptr;				// HANDLEs, kept as void* so <windows.h> stays out of this header
+	void*		m_hFileMapping = nullptr;
+#else
+	int			m_fd = -1;
+#endif
+	const char*	m_data = nullptr;
+	size_t		m_size = 0;
+	bool		m_isOpen = false;
 
 	bool open(const std::string& filename);
 
 public:
 
 	MemoryMapping(const std::string& filename);
+	~MemoryMapping();
+
+	MemoryMapping(const MemoryMapping&) = delete;
+	MemoryMapping& operator=(const MemoryMapping&) = delete;
 
-	char* getData();
+	const char* data() const;
+	size_t size() const;
+	std::string_view view() const;
+	bool isOpen() const;
 	void close();
-};
\ No newline at end of file
+};
@@ -5,7 +5,7 @@ bool Physics::IsInside(Vec2& pos, Entity e)
 {
 	auto ePos = e.getComponent<CTransform>().pos;
 	auto eScale = e.getComponent<CTransform>().scale;
-	auto size = e.getComponent<CAnimation>().animation.getSize();
+	auto size = e.getComponent<CAnimation>().animation->getSize();
 	float dx = fabs(pos.x - ePos.x);
 	float dy = fabs(pos.y - ePos.y);
 
@@ -38,9 +38,18 @@ Vec2 Physics::GetPreviousOverlap(Entity a, Entity b)
 	else { return Vec2(0, 0); }
 }
 
+// World space rect the entity's animation covers when drawn (rotation is ignored)
+sf::FloatRect Physics::GetDrawBounds(Entity e)
+{
+	auto& transform = e.getComponent<CTransform>();
+	auto& size = e.getComponent<CAnimation>().animation->getSize();
+	Vec2 scaled(size.x * fabs(transform.scale.x), size.y * fabs(transform.scale.y));
+	return sf::FloatRect({ transform.pos.x - scaled.x / 2, transform.pos.y - scaled.y / 2 }, { scaled.x, scaled.y });
+}
+
 bool Physics::IsInside(const Vec2& pos, Entity e)
 {
-	sf::FloatRect globalBounds = e.getComponent<CAnimation>().animation.getSprite().getGlobalBounds();
+	sf::FloatRect globalBounds = GetDrawBounds(e);
 	if (pos.x > globalBounds.position.x && pos.x < globalBounds.position.x + globalBounds.size.x &&
 		pos.y > globalBounds.position.y && pos.y < globalBounds.position.y + globalBounds.size.y)
 	{
@@ -71,7 +80,7 @@ Intersect Physics::LineIntersect(const Vec2& a, const Vec2& b, const Vec2& c, co
 
 bool Physics::EntityIntersect(const Vec2& a, const Vec2& b, Entity e)
 {
-	sf::FloatRect globalBounds = e.getComponent<CAnimation>().animation.getSprite().getGlobalBounds();
+	sf::FloatRect globalBounds = GetDrawBounds(e);
 	Vec2 topLeft = Vec2(globalBounds.position.x, globalBounds.position.y);
 	Vec2 topRight = Vec2(globalBounds.position.x + globalBounds.size.x, globalBounds.position.y);
 	Vec2 bottomLeft = Vec2(globalBounds.position.x, globalBounds.position.y + globalBounds.size.y);
@@ -18,6 +18,7 @@ public:
 	Vec2 static GetOverlap(Entity a, Entity b);
 	Vec2 static GetPreviousOverlap(Entity a, Entity b);
 	bool static IsInside(const Vec2& pos, Entity e);
+	sf::FloatRect static GetDrawBounds(Entity e);
 	Intersect LineIntersect(const Vec2& a, const Vec2& b, const Vec2& c, const Vec2& d);
 	bool EntityIntersect(const Vec2& a, const Vec2& b, Entity e);
 };
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "Profiler.h"
+
+#include <iomanip>
+#include <iostream>
+
+thread_local Profiler::ThreadBuffer* Profiler::t_buffer = nullptr;
+
+Profiler::~Profiler()
+{
+	stopCapture();
+}
+
+uint32_t Profiler::internName(const std::string& name)
+{
+	// Quotes would end the JSON string early
+	std::string escaped = name;
+	for (auto& c : escaped)
+	{
+		if (c == '"' || c == '\\') { c = '\''; }
+	}
+
+	std::lock_guard<std::mutex> lock(m_namesLock);
+	for (size_t i = 0; i < m_names.size(); i++)
+	{
+		if (m_names[i] == escaped) { return (uint32_t)i; }
+	}
+
+	m_names.push_back(escaped);
+	return (uint32_t)m_names.size() - 1;
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer()
+{
+	if (!t_buffer)
+	{
+		std::lock_guard<std::mutex> lock(m_buffersLock);
+		m_buffers.push_back(std::make_unique<ThreadBuffer>());
+		m_buffers.back()->threadIndex = m_buffers.size() - 1;
+		t_buffer = m_buffers.back().get();
+	}
+
+	return *t_buffer;
+}
+
+uint64_t Profiler::now() const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_captureStart).count();
+}
+
+void Profiler::record(const TraceEvent& event)
+{
+	ThreadBuffer& buffer = threadBuffer();
+	size_t head = buffer.head.load(std::memory_order_relaxed);
+	size_t tail = buffer.tail.load(std::memory_order_acquire);
+
+	if (head - tail >= BUFFER_SIZE)
+	{
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer.events[head & (BUFFER_SIZE - 1)] = event;
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+bool Profiler::startCapture(const std::string& path)
+{
+	if (m_capturing) { return false; }
+
+	m_output.open(path, std::ios::trunc);
+	if (!m_output.is_open())
+	{
+		std::cerr << "Could not open " << path << " to write the profile to" << std::endl;
+		return false;
+	}
+
+	// Anything left over from the last capture has the wrong time base
+	{
+		std::lock_guard<std::mutex> lock(m_buffersLock);
+		for (auto& buffer : m_buffers)
+		{
+			buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+			buffer->dropped = 0;
+		}
+	}
+
+	m_output << std::fixed << std::setprecision(3);
+	m_output << "{\"otherData\": {}, \"traceEvents\": [";
+	m_eventCount = 0;
+	m_captureStart = std::chrono::steady_clock::now();
+	m_stopFlushing = false;
+	m_flushThread = std::thread(&Profiler::flushLoop, this);
+	m_capturing.store(true, std::memory_order_release);
+
+	std::cout << "Profiling to " << path << "\n";
+	return true;
+}
+
+void Profiler::stopCapture()
+{
+	if (!m_capturing) { return; }
+	m_capturing = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_flushLock);
+		m_stopFlushing = true;
+	}
+	m_flushSignal.notify_one();
+	m_flushThread.join();
+
+	// Scopes that were running when the capture stopped may still push an event. It's dropped at the next start.
+	drain();
+
+	size_t dropped = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_buffersLock);
+		for (auto& buffer : m_buffers) { dropped += buffer->dropped; }
+	}
+
+	m_output << "]}";
+	m_output.close();
+
+	std::cout << "Profile captured " << m_eventCount << " events";
+	if (dropped > 0) { std::cout << " (" << dropped << " dropped, buffers were full)"; }
+	std::cout << "\n";
+}
+
+void Profiler::flushLoop()
+{
+	std::unique_lock<std::mutex> lock(m_flushLock);
+	while (!m_stopFlushing)
+	{
+		m_flushSignal.wait_for(lock, FLUSH_INTERVAL, [this] { return m_stopFlushing; });
+
+		lock.unlock();
+		drain();
+		lock.lock();
+	}
+}
+
+// Moves everything the threads have recorded so far into the output file
+void Profiler::drain()
+{
+	std::lock_guard<std::mutex> lock(m_buffersLock);
+	for (auto& buffer : m_buffers)
+	{
+		size_t tail = buffer->tail.load(std::memory_order_relaxed);
+		size_t head = buffer->head.load(std::memory_order_acquire);
+
+		for (; tail != head; tail++)
+		{
+			writeEvent(buffer->events[tail & (BUFFER_SIZE - 1)], buffer->threadIndex);
+		}
+
+		buffer->tail.store(tail, std::memory_order_release);
+	}
+}
+
+void Profiler::writeEvent(const TraceEvent& event, size_t threadIndex)
+{
+	const std::string* name = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_namesLock);
+		name = &m_names[event.nameId];
+	}
+
+	// Chrome wants microseconds, the fraction keeps nanosecond resolution so identical start times can't happen
+	if (m_eventCount++ > 0) { m_output << ","; }
+	m_output << "\n{";
+	m_output << "\"cat\":\"function\",";
+	m_output << "\"dur\":" << (event.end - event.start) / 1000.0 << ',';
+	m_output << "\"name\":\"" << *name << "\",";
+	m_output << "\"ph\":\"X\",";
+	m_output << "\"pid\":0, ";
+	m_output << "\"tid\":" << threadIndex << ",";
+	m_output << "\"ts\":" << event.start / 1000.0;
+	m_output << "}";
+}
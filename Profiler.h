@@ -1,16 +1,28 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <fstream>
+#include <memory>
 #include <mutex>
-#include <map>
 #include <string>
-#include <algorithm>
+#include <thread>
+#include <vector>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
 
 //#define PROFILING 1
 #ifdef PROFILING
+	// The name is interned once per call site, so a scope costs two clock reads and a push into this
+	// thread's buffer - and only a flag check when no capture is running
 	#define PROFILE_SCOPE(name) \
-		ProfileTimer timer##__LINE__(name)
+		static const uint32_t PROFILE_CONCAT(profileName, __LINE__) = Profiler::Instance().internName(name); \
+		ProfileTimer PROFILE_CONCAT(profileTimer, __LINE__)(PROFILE_CONCAT(profileName, __LINE__))
 	#define PROFILE_FUNCTION() \
 		PROFILE_SCOPE(__FUNCTION__)
 #else
@@ -18,30 +30,62 @@
 	#define PROFILE_FUNCTION()
 #endif
 
+// Times a system for a StatsOverlay whether or not PROFILING is on, and traces it like PROFILE_SCOPE when it is
+#define PROFILE_SYSTEM(stats, name) \
+	PROFILE_SCOPE(name); \
+	SystemTimer PROFILE_CONCAT(systemTimer, __LINE__)(stats, name)
 
-struct ProfileResult
+// One finished scope, nanoseconds since the capture started
+struct TraceEvent
 {
-	std::string name = "Default";
-	long long start = 0;
-	long long end = 0;
-	size_t threadID = 0;
+	uint64_t start = 0;
+	uint64_t end = 0;
+	uint32_t nameId = 0;
 };
 
+// Collects PROFILE_SCOPE timings between startCapture and stopCapture and writes them out in the Chrome
+// trace format (open the file in chrome://tracing or ui.perfetto.dev).
+//
+// Scopes never lock or touch the file: each thread pushes fixed size events into its own ring buffer,
+// which a background thread empties every FLUSH_INTERVAL and turns into JSON. If a thread fills its
+// buffer faster than that, new events are dropped and counted rather than blocking the thread.
 class Profiler
 {
-	std::string m_outputFile = "results.json";
-	size_t m_profileCount = 0;
-	std::ofstream m_outputStream;
-	std::mutex m_lock;
+	static constexpr size_t BUFFER_SIZE = 1 << 16;		// Events per thread, a power of two
+	static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 20 };
 
-	Profiler()
+	// Single producer (its thread) single consumer (the flush thread) ring
+	struct ThreadBuffer
 	{
-		m_outputStream = std::ofstream(m_outputFile);
-		writeHeader();
-	}
-
-	void writeHeader() { m_outputStream << "{\"otherData\": {}, \"traceEvents\": ["; }
-	void writeFooter() { m_outputStream << "]}"; }
+		std::array<TraceEvent, BUFFER_SIZE>		events;
+		std::atomic<size_t>						head = 0;			// Next slot the owner writes
+		std::atomic<size_t>						tail = 0;			// Next slot the flush thread reads
+		std::atomic<size_t>						dropped = 0;
+		size_t									threadIndex = 0;
+	};
+
+	std::vector<std::unique_ptr<ThreadBuffer>>	m_buffers;			// Never shrinks, buffers outlive their threads
+	std::mutex									m_buffersLock;		// Taken once per thread to register, and by the flush thread
+	std::deque<std::string>						m_names;			// Deque so the flush thread can hold on to one while more are added
+	std::mutex									m_namesLock;
+
+	std::atomic<bool>							m_capturing = false;
+	std::chrono::steady_clock::time_point		m_captureStart;
+	std::ofstream								m_output;
+	size_t										m_eventCount = 0;
+	std::thread									m_flushThread;
+	std::mutex									m_flushLock;
+	std::condition_variable						m_flushSignal;
+	bool										m_stopFlushing = false;
+
+	static thread_local ThreadBuffer*			t_buffer;			// This thread's, registered the first time it records anything
+
+	Profiler() {}
+
+	ThreadBuffer& threadBuffer();
+	void flushLoop();
+	void drain();
+	void writeEvent(const TraceEvent& event, size_t threadIndex);
 
 public:
 	static Profiler& Instance()
@@ -50,43 +94,27 @@ public:
 		return instance;
 	}
 
-	~Profiler()
-	{
-		writeFooter();
-	}
+	~Profiler();
 
-	void writeProfile(const ProfileResult& result)
-	{
-		std::lock_guard<std::mutex> lock(m_lock);
-
-		if (m_profileCount++ > 0) { m_outputStream << ","; }
-
-		std::string name = result.name;
-		std::replace(name.begin(), name.end(), '"', '\'');
-		m_outputStream << "\n{";
-		m_outputStream << "\"cat\":\"function\",";
-		m_outputStream << "\"dur\":" << (result.end - result.start) << ',';
-		m_outputStream << "\"name\":\"" << name << "\",";
-		m_outputStream << "\"ph\":\"X\",";
-		m_outputStream << "\"pid\":0, ";
-		m_outputStream << "\"tid\":" << result.threadID << ",";
-		m_outputStream << "\"ts\":" << result.start;
-		m_outputStream << "}";
-	}
+	uint32_t internName(const std::string& name);
+
+	bool startCapture(const std::string& path = "results.json");
+	void stopCapture();
+	bool isCapturing() const { return m_capturing.load(std::memory_order_acquire); }
+
+	uint64_t now() const;
+	void record(const TraceEvent& event);
 };
 
 class ProfileTimer
 {
-	typedef std::chrono::time_point<std::chrono::high_resolution_clock> ClockType;
+	TraceEvent m_event;
+	bool m_started = false;
 
-	ClockType m_startTimepoint;
-	ProfileResult m_result;
-	bool m_stopped = false;
 public:
-	// construct the profiler
-	ProfileTimer(const std::string& name)
-		: m_result({ name, 0, 0, 0 })
+	ProfileTimer(uint32_t nameId)
 	{
+		m_event.nameId = nameId;
 		start();
 	}
 
@@ -95,29 +123,20 @@ public:
 		stop();
 	}
 
-	// this function is used to set the start time
-	// it adds 1 time unit if its the same start time as the previous start time
-	// this solves a display issue in chrome://tracing for identical start times
-	// this is a 2/10 on the janky fix scale but it works in practice
 	void start()
 	{
-		static long long lastStartTime = 0;
-		m_startTimepoint = std::chrono::high_resolution_clock::now();
-		m_result.start = std::chrono::time_point_cast<std::chrono::microseconds>(m_startTimepoint).time_since_epoch().count();
-
-		m_result.start += (m_result.start == lastStartTime ? 1 : 0);
-		lastStartTime = m_result.start;
-		m_stopped = false;
+		m_started = Profiler::Instance().isCapturing();
+		if (m_started) { m_event.start = Profiler::Instance().now(); }
 	}
 
 	void stop()
 	{
-		if(m_stopped) { return; }
-		auto endTimepoint = std::chrono::high_resolution_clock::now();
-		m_result.end = std::chrono::time_point_cast<std::chrono::microseconds>(endTimepoint).time_since_epoch().count();
-		m_result.threadID = std::hash<std::thread::id>{}(std::this_thread::get_id());
-		Profiler::Instance().writeProfile(m_result);
+		if (!m_started) { return; }
+		m_started = false;
 
-		m_stopped = true;
+		// A scope that began before a capture started, or ends after it stopped, is left out
+		if (!Profiler::Instance().isCapturing()) { return; }
+		m_event.end = Profiler::Instance().now();
+		Profiler::Instance().record(m_event);
 	}
 };
@@ -14,14 +14,44 @@ void Scene::setPaused(bool paused)
 	m_paused = paused;
 }
 
+// Draw order of an entity's sprite in m_spriteBatch - scenery at the back, then tiles, then characters, then bullets
+uint8_t Scene::renderLayer(Entity e) const
+{
+	switch (e.tag())
+	{
+	case Tag::Decoration:
+	case Tag::Ladder:
+		return 0;
+	case Tag::Tile:
+	case Tag::Destroyable:
+		return 1;
+	case Tag::Bullet:
+		return 3;
+	default:
+		return 2;
+	}
+}
+
+void Scene::setInterpolation(float alpha)
+{
+	// Nothing moves while paused, so there's nothing to blend between
+	m_interpolation = m_paused ? 1.0f : alpha;
+}
+
+// Position to draw an entity at, between where it was on the previous tick and where it is now
+Vec2 Scene::interpolate(const CTransform& transform) const
+{
+	return transform.prevPos + (transform.pos - transform.prevPos) * m_interpolation;
+}
+
 size_t Scene::width() const
 {
-	return m_game->window().getSize().x;
+	return m_game->windowSize().x;
 }
 
 size_t Scene::height() const
 {
-	return m_game->window().getSize().y;
+	return m_game->windowSize().y;
 }
 
 size_t Scene::currentFrame() const
@@ -29,6 +59,11 @@ size_t Scene::currentFrame() const
 	return m_currentFrame;
 }
 
+size_t Scene::tick() const
+{
+	return m_tick;
+}
+
 const ActionMap& Scene::getActionMap() const
 {
 	return m_actionMap;
@@ -72,10 +107,24 @@ void Scene::simulate(const size_t frames)
 	for (size_t i = 0; i < frames; i++)
 	{
 		update();
+		m_tick++;
 	}
 }
 
 void Scene::doAction(const Action& action)
 {
+	// Everything that changes a scene apart from update() comes through here, so recording it is enough to replay a run
+	m_recorder.record(m_tick, action);
 	sDoAction(action);
+}
+
+void Scene::stopRecording()
+{
+	m_recorder.stop(m_tick, stateChecksum());
+}
+
+// Hash of the simulation's state, for checking a replay ended up where the recording did
+uint64_t Scene::stateChecksum() const
+{
+	return 0;
 }
\ No newline at end of file
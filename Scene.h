@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Action.h"
+#include "ActionRecorder.h"
 #include "EntityManager.h"
+#include "SpriteBatch.h"
 
 #include <memory>
 
@@ -19,9 +21,16 @@ protected:
 	bool				m_paused = false;
 	bool				m_hasEnded = false;
 	size_t				m_currentFrame = 0;
+	size_t				m_tick = 0;					// Calls to update() so far, paused or not. Actions are recorded against it
+	ActionRecorder		m_recorder;
+	SpriteBatch			m_spriteBatch;
+	float				m_interpolation = 1.0f;		// How far between the last two simulation ticks the next render is
 
 	virtual void onEnd() = 0;
 	void setPaused(bool paused);
+	static constexpr uint8_t RENDER_LAYER_COUNT = 4;
+	uint8_t renderLayer(Entity e) const;
+	Vec2 interpolate(const CTransform& transform) const;
 
 public:
 
@@ -34,11 +43,15 @@ public:
 
 	virtual void doAction(const Action& action);
 	void simulate(const size_t frames);
+	void stopRecording();
+	virtual uint64_t stateChecksum() const;
+	void setInterpolation(float alpha);
 	void registerAction(sf::Keyboard::Key inputKey, const std::string& actionName);
 
 	size_t width() const;
 	size_t height() const;
 	size_t currentFrame() const;
+	size_t tick() const;
 
 	bool hasEnded() const;
 	const ActionMap& getActionMap() const;
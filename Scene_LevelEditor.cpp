@@ -4,6 +4,8 @@
 #include "GameEngine.h"
 #include "Components.h"
 #include "Action.h"
+#include "MemoryMapping.h"
+#include "Tokenizer.h"
 
 #include <iostream>
 #include <fstream>
@@ -12,8 +14,8 @@
 Scene_LevelEditor::Scene_LevelEditor(GameEngine* gameEngine, const std::string& levelPath) :
 	Scene(gameEngine),
 	m_levelPath(levelPath),
-	m_gridText(m_game->assets().getFont("Sooky")),
-	m_player(m_entityManager.addEntity("Default"))
+	m_gridOverlay(m_game->assets().getFont("Sooky"), m_gridSize, 24),
+	m_player(m_entityManager.addEntity(Tag::Default))
 {
 	init(m_levelPath);
 }
@@ -31,8 +33,6 @@ void Scene_LevelEditor::init(const std::string& levelPath)
 
 	registerAction(sf::Keyboard::Key::Y, "SAVE");
 
-	m_gridText.setCharacterSize(24);
-
 	loadLevel(levelPath);
 }
 
@@ -46,8 +46,8 @@ Vec2 Scene_LevelEditor::gridToMidPixel(float gridX, float gridY, Entity entity)
 	//			The bottom-left corner of the Animation should align with the bottom left of the grid cell
 
 	float x = 0.0f, y = 0.0f;
-	x = (gridX * m_gridSize.x) + (entity.getComponent<CAnimation>().animation.getSize().x / 2);
-	y = m_game->window().getSize().y - (gridY * m_gridSize.y) - (entity.getComponent<CAnimation>().animation.getSize().y / 2 * entity.getComponent<CTransform>().scale.y);
+	x = (gridX * m_gridSize.x) + (entity.getComponent<CAnimation>().animation->getSize().x / 2);
+	y = m_game->windowSize().y - (gridY * m_gridSize.y) - (entity.getComponent<CAnimation>().animation->getSize().y / 2 * entity.getComponent<CTransform>().scale.y);
 
 	return Vec2(x, y);
 }
@@ -56,17 +56,17 @@ Vec2 Scene_LevelEditor::mouseToGrid(Vec2 mousePos, Entity entity)
 {
 	Vec2 gridLoc;
 	gridLoc.x = int(mousePos.x / m_gridSize.x);
-	gridLoc.y = int((m_game->window().getSize().y - mousePos.y) / m_gridSize.y);
+	gridLoc.y = int((m_game->windowSize().y - mousePos.y) / m_gridSize.y);
 
 	return gridLoc;
 }
 
 Vec2 Scene_LevelEditor::windowToWorld(const Vec2& windowPos) const
 {
-	auto view = m_game->window().getView();
+	auto view = m_game->view();
 
-	float wx = view.getCenter().x - (m_game->window().getSize().x / 2);
-	float wy = view.getCenter().y - (m_game->window().getSize().y / 2);
+	float wx = view.getCenter().x - (m_game->windowSize().x / 2);
+	float wy = view.getCenter().y - (m_game->windowSize().y / 2);
 
 	return Vec2(windowPos.x + wx, windowPos.y + wy);
 }
@@ -79,7 +79,8 @@ void Scene_LevelEditor::loadLevel(const std::string& filename)
 	// Reset the entity manager every time we load a level
 	m_entityManager = EntityManager();
 
-	std::ifstream fin(filename);
+	MemoryMapping mm(filename);
+	Tokenizer fin(mm.view());
 	std::string item = "";
 
 	while (fin >> item)
@@ -135,6 +136,11 @@ void Scene_LevelEditor::loadLevel(const std::string& filename)
 		}
 	}
 
+	if (!fin.atEnd())
+	{
+		std::cerr << filename << ":" << fin.line() << ":" << fin.column() << ": unreadable level record, the rest of the level was skipped\n";
+	}
+
 	spawnPlayer();
 	spawnPoolBackground(m_poolBackground);
 
@@ -202,10 +208,10 @@ void Scene_LevelEditor::saveLevel(const std::string& levelPath)
 		{
 			for (auto e : m_entityManager.getEntities())
 			{
-				if (e.tag() == "Player")
+				if (e.tag() == Tag::Player)
 				{
 					fout <<
-						e.tag() << " " <<
+						e.tagName() << " " <<
 						e.getComponent<CGridLocation>().x << " " <<
 						e.getComponent<CGridLocation>().y << " " <<
 						m_playerConfig.collisionX << " " <<
@@ -216,12 +222,12 @@ void Scene_LevelEditor::saveLevel(const std::string& levelPath)
 						m_playerConfig.gravity << " " <<
 						m_playerConfig.WEAPON << " \n";
 				}
-				if (e.tag() == "Enemy")
+				if (e.tag() == Tag::Enemy)
 				{
 					fout << 
-						e.tag() << " " << 
+						e.tagName() << " " << 
 						e.getComponent<CEnemyType>().type << " " << 
-						e.getComponent<CAnimation>().animation.getName() << " " << 
+						e.getComponent<CAnimation>().animation->getName() << " " << 
 						e.getComponent<CGridLocation>().x << " " << 
 						e.getComponent<CGridLocation>().y << " " <<
 						e.getComponent<CBoundingBox>().size.x << " " <<
@@ -235,11 +241,11 @@ void Scene_LevelEditor::saveLevel(const std::string& levelPath)
 						e.getComponent<CGravity>().gravity << " " <<
 						int(e.getComponent<CDamage>().damage) << " \n";
 				}
-				if (e.tag() == "Tile" || e.tag() == "Decoration" || e.tag() == "Ladder" || e.tag() == "Destroyable")
+				if (e.tag() == Tag::Tile || e.tag() == Tag::Decoration || e.tag() == Tag::Ladder || e.tag() == Tag::Destroyable)
 				{
 					fout << 
-						e.tag() << " " << 
-						e.getComponent<CAnimation>().animation.getName() << " " << 
+						e.tagName() << " " << 
+						e.getComponent<CAnimation>().animation->getName() << " " << 
 						e.getComponent<CGridLocation>().x << " " << 
 						e.getComponent<CGridLocation>().y << " \n";
 				}
@@ -262,8 +268,8 @@ void Scene_LevelEditor::saveLevel(const std::string& levelPath)
 
 void Scene_LevelEditor::spawnEnemy(EnemyConfig& enemy, bool isPool)
 {
-	auto entity = isPool ? m_entityPoolManager.addEntity("Enemy") : m_entityManager.addEntity("Enemy");
-	entity.addComponent<CState>("ALIVE");
+	auto entity = isPool ? m_entityPoolManager.addEntity(Tag::Enemy) : m_entityManager.addEntity(Tag::Enemy);
+	entity.addComponent<CState>(State::Alive);
 	entity.addComponent<CAnimation>(m_game->assets().getAnimation(enemy.animationName), true);
 	entity.addComponent<CEnemyType>(enemy.enemyType);
 	entity.addComponent<CTransform>();
@@ -285,8 +291,8 @@ void Scene_LevelEditor::spawnEnemy(EnemyConfig& enemy, bool isPool)
 	if (isPool)
 	{
 		float scaleX = 0.0f, scaleY = 0.0f;
-		scaleX = 1 / (entity.getComponent<CAnimation>().animation.getSize().x / 64);
-		scaleY = 1 / (entity.getComponent<CAnimation>().animation.getSize().y / 64);
+		scaleX = 1 / (entity.getComponent<CAnimation>().animation->getSize().x / 64);
+		scaleY = 1 / (entity.getComponent<CAnimation>().animation->getSize().y / 64);
 		entity.getComponent<CTransform>().scale = { scaleX, scaleY };
 		//entity.getComponent<CAnimation>().animation.getSprite().setScale({ scaleX, scaleY });
 
@@ -297,8 +303,9 @@ void Scene_LevelEditor::spawnEnemy(EnemyConfig& enemy, bool isPool)
 
 void Scene_LevelEditor::loadTileSheet(const std::string& tilesheet)
 {
-	std::ifstream fin(tilesheet);
-	if (fin.is_open())
+	MemoryMapping mm(tilesheet);
+	Tokenizer fin(mm.view());
+	if (mm.isOpen())
 	{
 		std::string entityType = "";
 		std::string entityAnim = "";
@@ -339,12 +346,12 @@ void Scene_LevelEditor::loadTileSheet(const std::string& tilesheet)
 
 			// For any entity which is larger than 64 x 64 - we need to scale down to 64x64 for the tile pool
 			// to prevent any overlapping, which causes multiple entities to be picked up with one mouse click
-			if (ne.getComponent<CAnimation>().animation.getSize().y > 64 ||
-				ne.getComponent<CAnimation>().animation.getSize().x > 64)
+			if (ne.getComponent<CAnimation>().animation->getSize().y > 64 ||
+				ne.getComponent<CAnimation>().animation->getSize().x > 64)
 			{
 				float scaleX = 0.0f, scaleY = 0.0f;
-				scaleX = 1 / (ne.getComponent<CAnimation>().animation.getSize().x / 64);
-				scaleY = 1 / (ne.getComponent<CAnimation>().animation.getSize().y / 64);
+				scaleX = 1 / (ne.getComponent<CAnimation>().animation->getSize().x / 64);
+				scaleY = 1 / (ne.getComponent<CAnimation>().animation->getSize().y / 64);
 				ne.getComponent<CTransform>().scale = { scaleX, scaleY };
 
 				//ne.getComponent<CAnimation>().animation.getSprite().setScale(sf::Vector2f(scaleX, scaleY));
@@ -360,19 +367,20 @@ void Scene_LevelEditor::loadTileSheet(const std::string& tilesheet)
 
 void Scene_LevelEditor::spawnPoolBackground(sf::RectangleShape& background)
 {
-	background = sf::RectangleShape({ 256.0f, float(m_game->window().getView().getSize().y)});
+	background = sf::RectangleShape({ 256.0f, float(m_game->view().getSize().y)});
 	background.setFillColor(sf::Color::Red);
 	background.setPosition({ 0, 0});
 }
 
 void Scene_LevelEditor::spawnPlayer()
 {
-	m_player = m_entityManager.addEntity("Player");
+	m_player = m_entityManager.addEntity(Tag::Player);
 	m_player.addComponent<CAnimation>(m_game->assets().getAnimation("PlayerIdle"), true);
 	m_player.addComponent<CTransform>(Vec2(gridToMidPixel(m_playerConfig.gridX, m_playerConfig.gridY, m_player)));
 	m_player.addComponent<CGridLocation>(m_playerConfig.gridX, m_playerConfig.gridY);
 	m_player.addComponent<CDraggable>();
-	m_camPos = { float(m_game->window().getSize().x / 2), float(m_game->window().getSize().y / 2) };
+	m_player.addComponent<CInput>();
+	m_camPos = { float(m_game->windowSize().x / 2), float(m_game->windowSize().y / 2) };
 }
 
 void Scene_LevelEditor::update()
@@ -384,15 +392,14 @@ void Scene_LevelEditor::update()
 	sDragAndDrop();
 	sMovement();
 	sCamera();
-	sRender();
 
 	m_currentFrame++;
 }
 
 void Scene_LevelEditor::sEntityPool()
 {
-	float relativeX = m_game->window().getView().getCenter().x + (m_game->window().getSize().x / 2) - 256;
-	float relativeY = m_game->window().getView().getCenter().y - (m_game->window().getView().getSize().y / 2);
+	float relativeX = m_game->view().getCenter().x + (m_game->windowSize().x / 2) - 256;
+	float relativeY = m_game->view().getCenter().y - (m_game->view().getSize().y / 2);
 	float xLoc = 0.0f;
 	float yLoc = 0.0f;
 	m_poolBackground.setPosition({ relativeX, relativeY });
@@ -427,9 +434,9 @@ void Scene_LevelEditor::sEntityPool()
 
 void Scene_LevelEditor::sDragAndDrop()
 {
-	for (auto e : m_entityManager.getEntities())
+	for (auto e : m_entityManager.view<CTransform, CDraggable>())
 	{
-		if (e.hasComponent<CDraggable>() && e.getComponent<CDraggable>().dragging)
+		if (e.getComponent<CDraggable>().dragging)
 		{
 			e.getComponent<CTransform>().pos = windowToWorld(m_mPos);
 		}
@@ -439,9 +446,9 @@ void Scene_LevelEditor::sDragAndDrop()
 void Scene_LevelEditor::sCamera()
 {
 	// Camera in the Level Editor should be controllable
-	sf::View view = m_game->window().getView();
+	sf::View view = m_game->view();
 	view.setCenter({ m_camPos.x, m_camPos.y });
-	m_game->window().setView(view);
+	m_game->setView(view);
 }
 
 void Scene_LevelEditor::sMovement()
@@ -484,25 +491,25 @@ void Scene_LevelEditor::sDoAction(const Action& action)
 		if (action.name() == "LEFT_CLICK")
 		{
 			Vec2 worldPos = windowToWorld(action.pos());
-			if (action.pos().x > m_game->window().getSize().x - 256)
+			if (action.pos().x > m_game->windowSize().x - 256)
 			{
 				for (auto e : m_entityPoolManager.getEntities())
 				{
 					if (Physics::IsInside(worldPos, e))
 					{
-						if (e.tag() == "Player")
+						if (e.tag() == Tag::Player)
 						{
 							std::cout << "Error: Player already exists.\n";
 						}
 						else
 						{
 							auto ne = m_entityManager.addEntity(e.tag());
-							ne.addComponent<CAnimation>(m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getName()));
+							ne.addComponent<CAnimation>(*e.getComponent<CAnimation>().animation);
 							ne.addComponent<CTransform>();
 							ne.getComponent<CTransform>().pos = action.pos();
 							ne.addComponent<CDraggable>().dragging = true;
 							ne.addComponent<CGridLocation>();
-							if (ne.tag() == "Enemy")
+							if (ne.tag() == Tag::Enemy)
 							{
 								ne.addComponent<CEnemyType>(e.getComponent<CEnemyType>().type);
 								ne.addComponent<CBoundingBox>(Vec2(e.getComponent<CBoundingBox>().size));
@@ -511,7 +518,7 @@ void Scene_LevelEditor::sDoAction(const Action& action)
 								ne.addComponent<CAttacking>();
 								ne.getComponent<CAttacking>().attackType = e.getComponent<CAttacking>().attackType;
 								ne.getComponent<CAttacking>().coolDown = e.getComponent<CAttacking>().coolDown;
-								ne.addComponent<CGravity>().gravity = e.getComponent<CGravity>().gravity;
+								ne.addComponent<CGravity>(e.getComponent<CGravity>().gravity);
 							}
 						}
 					}
@@ -525,7 +532,7 @@ void Scene_LevelEditor::sDoAction(const Action& action)
 				{
 					if (e.hasComponent<CDraggable>() && Physics::IsInside(worldPos, e))
 					{
-						std::cout << "CLICKED ON ENTITY: " << e.getComponent<CAnimation>().animation.getName() << std::endl;
+						std::cout << "CLICKED ON ENTITY: " << e.getComponent<CAnimation>().animation->getName() << std::endl;
 						e.getComponent<CDraggable>().dragging = !e.getComponent<CDraggable>().dragging;
 						if (!e.getComponent<CDraggable>().dragging)
 						{
@@ -575,67 +582,41 @@ void Scene_LevelEditor::sRender()
 	// Draw all Entity textures + animations
 	if (m_drawTextures)
 	{
-		for (auto e : m_entityManager.getEntities())
+		m_spriteBatch.clear();
+		for (auto e : m_entityManager.view<CTransform, CAnimation>())
 		{
-			auto& transform = e.getComponent<CTransform>();
-
-			if (e.hasComponent<CAnimation>())
-			{
-				auto& animation = e.getComponent<CAnimation>().animation;
-				animation.getSprite().setRotation(sf::degrees(transform.angle));
-				animation.getSprite().setPosition({ transform.pos.x, transform.pos.y });
-				animation.getSprite().setScale({ transform.scale.x, transform.scale.y });
-				m_game->window().draw(animation.getSprite());
-			}
+			m_spriteBatch.add(e.getComponent<CAnimation>(), e.getComponent<CTransform>(), renderLayer(e));
 		}
+		m_spriteBatch.draw(m_game->window());
 
+		// The entity pool sits on top of the level, so it gets its own batch after the pool background
 		sEntityPool();
+		m_spriteBatch.clear();
 		for (auto e : m_entityPoolManager.getEntities())
 		{
 			auto& transform = e.getComponent<CTransform>();
-			auto& animation = e.getComponent<CAnimation>().animation;
+			auto& animation = e.getComponent<CAnimation>();
 
 			if (e.getComponent<CDestroyable>().has)
 			{
-				sf::RectangleShape rect({ float(animation.getSprite().getTexture().getSize().x), float(animation.getSprite().getTexture().getSize().y)});
+				auto& size = animation.animation->getSize();
+				sf::RectangleShape rect({ size.x, size.y });
 				rect.setOutlineColor(sf::Color::Green);
 				rect.setOutlineThickness(4);
-				rect.setPosition({ transform.pos.x - (animation.getSprite().getTexture().getSize().x / 2), transform.pos.y - (animation.getSprite().getTexture().getSize().y / 2)});
+				rect.setPosition({ transform.pos.x - (size.x / 2), transform.pos.y - (size.y / 2)});
 				m_game->window().draw(rect);
 			}
 
-			animation.getSprite().setRotation(sf::degrees(transform.angle));
-			animation.getSprite().setPosition({ transform.pos.x, transform.pos.y });
-			animation.getSprite().setScale({ transform.scale.x, transform.scale.y });
-			m_game->window().draw(animation.getSprite());
+			m_spriteBatch.add(animation, transform, 0);
 		}
+		m_spriteBatch.draw(m_game->window());
 	}
 
 	// Draw the grid for easy viewing of tile placement and world size
 	if (m_drawGrid)
 	{
-		float leftX = m_game->window().getView().getCenter().x - width() / 2;
-		float rightX = leftX + width() + m_gridSize.x;
-		float nextGridX = leftX - ((int)leftX % (int)m_gridSize.x);
-
-		for (float x = nextGridX; x < rightX; x += m_gridSize.x)
-		{
-			drawLine(Vec2(x, 0.0f), Vec2(x, (float)height()));
-		}
-
-		for (float y = 0; y < height(); y += m_gridSize.y)
-		{
-			drawLine(Vec2(leftX, height() - y), Vec2(rightX, height() - y));
-
-			for (float x = nextGridX; x < rightX; x += m_gridSize.x)
-			{
-				std::string xCell = std::to_string((int)x / (int)m_gridSize.x);
-				std::string yCell = std::to_string((int)y / (int)m_gridSize.y);
-				m_gridText.setString("(" + xCell + "," + yCell + ")");
-				m_gridText.setPosition({ x + 3, height() - y - m_gridSize.y + 2 });
-				m_game->window().draw(m_gridText);
-			}
-		}
+		// Row 0 sits on the bottom of the window, like the level's grid coordinates
+		m_gridOverlay.draw(m_game->window(), (float)height());
 	}
 	m_mouseShape.setFillColor(sf::Color(255, 0, 0));
 	m_mouseShape.setRadius(4);
@@ -643,14 +624,13 @@ void Scene_LevelEditor::sRender()
 	Vec2 worldPos = windowToWorld(m_mPos);
 	m_mouseShape.setPosition({ worldPos.x, worldPos.y });
 	m_game->window().draw(m_mouseShape);
-	m_currentFrame++;
 }
 
 void Scene_LevelEditor::onEnd()
 {
 	m_hasEnded = true;
-	sf::View view = m_game->window().getView();
-	view.setCenter({ m_game->window().getSize().x / 2.0f, m_game->window().getSize().y / 2.0f });
-	m_game->window().setView(view);
+	sf::View view = m_game->view();
+	view.setCenter({ m_game->windowSize().x / 2.0f, m_game->windowSize().y / 2.0f });
+	m_game->setView(view);
 	m_game->changeScene("MENU", nullptr, true);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Scene.h"
 #include "EntityManager.h"
+#include "GridOverlay.h"
 
 #include <map>
 #include <memory>
@@ -33,7 +34,7 @@ protected:
 	bool								m_drawTextures = true;
 	bool								m_drawGrid = false;
 	const Vec2							m_gridSize = { 64, 64 };
-	sf::Text							m_gridText;
+	GridOverlay							m_gridOverlay;
 
 	Vec2								m_camPos;
 	Vec2								m_mPos;
@@ -0,0 +1,68 @@
+#include "Scene_Loading.h"
+#include "Scene_Menu.h"
+#include "GameEngine.h"
+
+Scene_Loading::Scene_Loading(GameEngine* gameEngine) :
+	Scene(gameEngine),
+	m_text(m_game->assets().getFont("Sooky"), "Loading", 40)
+{
+	init();
+}
+
+void Scene_Loading::init()
+{
+	m_text.setOutlineColor(sf::Color::Black);
+	m_text.setOutlineThickness(3);
+
+	m_barBackground.setFillColor(sf::Color::Black);
+	m_barBackground.setOutlineColor(sf::Color::White);
+	m_barBackground.setOutlineThickness(2);
+	m_bar.setFillColor(sf::Color(180, 0, 0));
+
+	registerAction(sf::Keyboard::Key::Escape, "QUIT");
+}
+
+void Scene_Loading::update()
+{
+	// The menu needs the atlas, so it can't be made until everything is in
+	if (m_game->assets().updateLoading())
+	{
+		m_game->changeScene("MENU", std::make_shared<Scene_Menu>(m_game), true);
+		return;
+	}
+
+	m_currentFrame++;
+}
+
+void Scene_Loading::onEnd()
+{
+	m_game->quit();
+}
+
+void Scene_Loading::sDoAction(const Action& action)
+{
+	if (action.type() == "START" && action.name() == "QUIT")
+	{
+		onEnd();
+	}
+}
+
+void Scene_Loading::sRender()
+{
+	auto& window = m_game->window();
+	window.clear(sf::Color(67, 0, 0));
+
+	const sf::Vector2f windowSize((float)m_game->windowSize().x, (float)m_game->windowSize().y);
+	const sf::Vector2f barSize(windowSize.x * 0.5f, 30.0f);
+	const sf::Vector2f barPos((windowSize.x - barSize.x) / 2.0f, windowSize.y * 0.6f);
+
+	m_barBackground.setSize(barSize);
+	m_barBackground.setPosition(barPos);
+	m_bar.setSize({ barSize.x * m_game->assets().loadingProgress(), barSize.y });
+	m_bar.setPosition(barPos);
+	window.draw(m_barBackground);
+	window.draw(m_bar);
+
+	m_text.setPosition({ windowSize.x / 2.0f - m_text.getLocalBounds().size.x / 2.0f, barPos.y - m_text.getLocalBounds().size.y - 30.0f });
+	window.draw(m_text);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Scene.h"
+
+// Shown while Assets decode on their worker threads. Draws a progress bar and moves on to the menu
+// once the atlas has been uploaded.
+class Scene_Loading : public Scene
+{
+
+protected:
+
+	sf::Text						m_text;
+	sf::RectangleShape				m_barBackground;
+	sf::RectangleShape				m_bar;
+
+	void init();
+	void update();
+	void onEnd();
+	void sDoAction(const Action& action);
+
+public:
+
+	Scene_Loading(GameEngine* gameEngine);
+	void sRender();
+};
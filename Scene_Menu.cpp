@@ -39,11 +39,11 @@ void Scene_Menu::init()
 	m_levelPaths.push_back("levels/level4.txt");
 	m_levelPaths.push_back("levels/level5.txt");
 
-	auto menuCharacter = m_entityManager.addEntity("Tile");
+	auto menuCharacter = m_entityManager.addEntity(Tag::Tile);
 	menuCharacter.addComponent<CAnimation>(m_game->assets().getAnimation("PlayerRun"), true);
 	menuCharacter.addComponent<CTransform>();
 	menuCharacter.getComponent<CTransform>().scale = { 2, 2 };
-	menuCharacter.getComponent<CTransform>().pos = { (float)m_game->window().getSize().x / 2.0f, (float)m_game->window().getSize().y / 2.0f };
+	menuCharacter.getComponent<CTransform>().pos = { (float)m_game->windowSize().x / 2.0f, (float)m_game->windowSize().y / 2.0f };
 
 	registerAction(sf::Keyboard::Key::W,		"UP");
 	registerAction(sf::Keyboard::Key::S,		"DOWN");
@@ -58,7 +58,6 @@ void Scene_Menu::update()
 	m_entityManager.update();
 
 	sAnimation();
-	sRender();
 
 	m_currentFrame++;
 }
@@ -108,12 +107,9 @@ void Scene_Menu::sDoAction(const Action& action)
 
 void Scene_Menu::sAnimation()
 {
-	for (auto e : m_entityManager.getEntities())
+	for (auto e : m_entityManager.view<CAnimation>())
 	{
-		if (e.hasComponent<CAnimation>())
-		{
-			e.getComponent<CAnimation>().animation.update();
-		}
+		e.getComponent<CAnimation>().update();
 	}
 }
 
@@ -185,17 +181,11 @@ void Scene_Menu::sRender()
 			m_menuTextBackground.setOutlineThickness(2);
 		}
 
-		for (auto e : m_entityManager.getEntities())
+		for (auto e : m_entityManager.view<CTransform, CAnimation>())
 		{
 			auto& transform = e.getComponent<CTransform>();
-
-			if (e.hasComponent<CAnimation>())
-			{
-				auto& animation = e.getComponent<CAnimation>().animation;
-				animation.getSprite().setPosition({ transform.pos.x, transform.pos.y });
-				animation.getSprite().setScale({ transform.scale.x, transform.scale.y });
-				m_game->window().draw(animation.getSprite());
-			}
+			auto& animation = e.getComponent<CAnimation>();
+			m_game->window().draw(animation.getSprite(transform.pos, transform.scale, transform.angle));
 		}
 
 		window.draw(m_menuTextBackground);
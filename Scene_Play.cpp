@@ -4,15 +4,18 @@
 #include "GameEngine.h"
 #include "Components.h"
 #include "Action.h"
+#include "Profiler.h"
+#include "MemoryMapping.h"
+#include "Tokenizer.h"
 
 #include <iostream>
-#include <fstream>
 
 Scene_Play::Scene_Play(GameEngine* gameEngine, const std::string& levelPath) :
 	Scene(gameEngine),
 	m_levelPath(levelPath),
-	m_gridText(m_game->assets().getFont("Sooky")),
-	m_player(m_entityManager.addEntity("Default"))
+	m_gridOverlay(m_game->assets().getFont("Sooky"), m_gridSize, 24),
+	m_stats(m_game->assets().getFont("Alagard"), 18),
+	m_player(m_entityManager.addEntity(Tag::Default))
 {
 	init(m_levelPath);
 }
@@ -24,6 +27,7 @@ void Scene_Play::init(const std::string& levelPath)
 	registerAction(sf::Keyboard::Key::T,			"TOGGLE_TEXTURE");				// Toggle drawing (T)extures
 	registerAction(sf::Keyboard::Key::C,			"TOGGLE_COLLISION");			// Toggle drawing (C)ollision Boxes
 	registerAction(sf::Keyboard::Key::G,			"TOGGLE_GRID");					// Toggle drawing (G)rid
+	registerAction(sf::Keyboard::Key::F3,			"TOGGLE_STATS");				// Toggle the performance overlay
 
 	registerAction(sf::Keyboard::Key::Space,		"JUMP");
 	registerAction(sf::Keyboard::Key::Enter,		"SHOOT");
@@ -33,9 +37,16 @@ void Scene_Play::init(const std::string& levelPath)
 	registerAction(sf::Keyboard::Key::S,			"CROUCH");
 	//registerAction((sf::Keyboard::Key)sf::Mouse::Button::Right,		"SPECIAL");
 
-	m_gridText.setCharacterSize(24);
-
 	loadLevel(levelPath);
+
+	auto center = m_game->view().getCenter();
+	m_prevCameraCenter = Vec2(center.x, center.y);
+
+	// Recording starts with the level so a replay can start from a freshly loaded one too
+	if (!m_game->recordPath().empty())
+	{
+		m_recorder.start(m_game->recordPath(), levelPath, m_game->tickRate());
+	}
 }
 
 // IMPORTANT: Always add the CAnimation component first so that gridToMidPixel can compute correctly
@@ -48,18 +59,22 @@ Vec2 Scene_Play::gridToMidPixel(float gridX, float gridY, Entity entity)
 	//			The bottom-left corner of the Animation should align with the bottom left of the grid cell
 
 	float x = 0.0f, y = 0.0f;
-	x = (gridX * m_gridSize.x) + (entity.getComponent<CAnimation>().animation.getSize().x / 2);
-	y = m_game->window().getSize().y - (gridY * m_gridSize.y) - (entity.getComponent<CAnimation>().animation.getSize().y / 2 * entity.getComponent<CTransform>().scale.y);
+	x = (gridX * m_gridSize.x) + (entity.getComponent<CAnimation>().animation->getSize().x / 2);
+	y = m_game->windowSize().y - (gridY * m_gridSize.y) - (entity.getComponent<CAnimation>().animation->getSize().y / 2 * entity.getComponent<CTransform>().scale.y);
 
 	return Vec2(x, y);
 }
 
 Vec2 Scene_Play::windowToWorld(const Vec2& windowPos) const
 {
-	auto view = m_game->window().getView();
+	return windowToWorld(windowPos, m_game->view());
+}
 
-	float wx = view.getCenter().x - (m_game->window().getSize().x / 2);
-	float wy = view.getCenter().y - (m_game->window().getSize().y / 2);
+// Same, but for a view other than the camera's - sRender draws with an interpolated one
+Vec2 Scene_Play::windowToWorld(const Vec2& windowPos, const sf::View& view) const
+{
+	float wx = view.getCenter().x - (m_game->windowSize().x / 2);
+	float wy = view.getCenter().y - (m_game->windowSize().y / 2);
 
 	return Vec2(windowPos.x + wx, windowPos.y + wy);
 }
@@ -68,8 +83,13 @@ void Scene_Play::loadLevel(const std::string& filename)
 {
 	// Reset the entity manager every time we load a level
 	m_entityManager = EntityManager();
+	m_staticGrid = SpatialHash(m_gridSize);
+	m_dynamicGrid = SpatialHash(m_gridSize);
+	m_sceneryGrid = SpatialHash(m_gridSize);
+	m_tileChunks = TileChunkCache(m_gridSize * 16);
 
-	std::ifstream fin(filename);
+	MemoryMapping mm(filename);
+	Tokenizer fin(mm.view());
 	std::string entityType = "";
 
 	while (fin >> entityType)
@@ -86,6 +106,7 @@ void Scene_Play::loadLevel(const std::string& filename)
 			entity.addComponent<CAnimation>(m_game->assets().getAnimation(name), true);
 			entity.addComponent<CTransform>();
 			entity.getComponent<CTransform>().pos = gridToMidPixel(tileGX, tileGY, entity);
+			entity.getComponent<CTransform>().prevPos = entity.getComponent<CTransform>().pos;
 			entity.addComponent<CDraggable>();
 			if (entityType == "Decoration")
 			{
@@ -94,19 +115,24 @@ void Scene_Play::loadLevel(const std::string& filename)
 			if (entityType == "Tile" || entityType == "Destroyable")
 			{
 				// Decorations should not have a bounding box
-				entity.addComponent<CBoundingBox>(Vec2(entity.getComponent<CAnimation>().animation.getSize().x, entity.getComponent<CAnimation>().animation.getSize().y));
-				entity.addComponent<CState>("ALIVE");
+				entity.addComponent<CBoundingBox>(Vec2(entity.getComponent<CAnimation>().animation->getSize().x, entity.getComponent<CAnimation>().animation->getSize().y));
+				entity.addComponent<CState>(State::Alive);
 
 				if (entityType == "Destroyable")
 				{
 					entity.addComponent<CDestroyable>();
 				}
+
+				m_staticGrid.insert(entity, entity.getComponent<CTransform>().pos, entity.getComponent<CBoundingBox>().halfSize);
 			}
 			if (entityType == "Ladder")
 			{
-				entity.addComponent<CBoundingBox>(Vec2(entity.getComponent<CAnimation>().animation.getSize().x / 2.0f, entity.getComponent<CAnimation>().animation.getSize().y));
+				entity.addComponent<CBoundingBox>(Vec2(entity.getComponent<CAnimation>().animation->getSize().x / 2.0f, entity.getComponent<CAnimation>().animation->getSize().y));
 				entity.addComponent<CClimbable>();
 			}
+
+			m_sceneryGrid.insert(entity, entity.getComponent<CTransform>().pos, drawHalfSize(entity));
+			m_tileChunks.add(entity, renderLayer(entity));
 		}
 		else if (entityType == "Enemy")
 		{
@@ -145,17 +171,23 @@ void Scene_Play::loadLevel(const std::string& filename)
 		}
 	}
 
+	if (!fin.atEnd())
+	{
+		std::cerr << filename << ":" << fin.line() << ":" << fin.column() << ": unreadable level record, the rest of the level was skipped\n";
+	}
+
 	spawnPlayer();
 }
 
 void Scene_Play::spawnPlayer()
 {
-	m_player = m_entityManager.addEntity("Player");
+	m_player = m_entityManager.addEntity(Tag::Player);
 	m_player.addComponent<CAnimation>(m_game->assets().getAnimation("PlayerJump"), true);
 	m_player.addComponent<CTransform>(Vec2(gridToMidPixel(m_playerConfig.gridX, m_playerConfig.gridY, m_player)));
-	m_player.addComponent<CState>().state = "JUMPING";
+	m_player.addComponent<CState>(State::Jumping);
 	m_player.addComponent<CBoundingBox>(Vec2(m_playerConfig.collisionX, m_playerConfig.collisionY));
 	m_player.addComponent<CGravity>(m_playerConfig.gravity);
+	m_player.addComponent<CInput>();
 	m_player.addComponent<CInvulnerable>();
 	m_player.addComponent<CHealth>();
 	m_player.getComponent<CHealth>().currentHealth = 5;
@@ -164,8 +196,8 @@ void Scene_Play::spawnPlayer()
 
 void Scene_Play::spawnEnemy(EnemyConfig& enemy)
 {
-	auto entity = m_entityManager.addEntity("Enemy");
-	entity.addComponent<CState>("ALIVE");
+	auto entity = m_entityManager.addEntity(Tag::Enemy);
+	entity.addComponent<CState>(State::Alive);
 	entity.addComponent<CAnimation>(m_game->assets().getAnimation(enemy.animationName), true);
 	entity.addComponent<CTransform>();
 	entity.getComponent<CTransform>().pos = gridToMidPixel(enemy.gridX, enemy.gridY, entity);
@@ -181,7 +213,7 @@ void Scene_Play::spawnEnemy(EnemyConfig& enemy)
 	if (entity.getComponent<CAttacking>().attackType == "HITSCAN")
 	{
 		entity.addComponent<CRayCaster>(Vec2(entity.getComponent<CTransform>().pos.x, entity.getComponent<CTransform>().pos.y));
-		entity.getComponent<CRayCaster>().maxRange = m_game->window().getView().getSize().x / 2;
+		entity.getComponent<CRayCaster>().maxRange = m_game->view().getSize().x / 2;
 	}
 	else if (entity.getComponent<CAttacking>().attackType == "PROJECTILE")
 	{
@@ -200,20 +232,20 @@ void Scene_Play::spawnEnemy(EnemyConfig& enemy)
 
 void Scene_Play::spawnBullet(Entity entity)
 {
-	auto bullet = m_entityManager.addEntity("Bullet");
+	auto bullet = m_entityManager.addEntity(Tag::Bullet);
 	bullet.addComponent<CTransform>(Vec2(entity.getComponent<CTransform>().pos.x, entity.getComponent<CTransform>().pos.y));
 	bullet.getComponent<CTransform>().scale = entity.getComponent<CTransform>().scale;
 	bullet.getComponent<CTransform>().velocity.x = bullet.getComponent<CTransform>().scale.x * 15;
 	bullet.addComponent<CAnimation>(m_game->assets().getAnimation("BulletIdle"), true);
-	bullet.addComponent<CBoundingBox>(bullet.getComponent<CAnimation>().animation.getSize() * 0.90f);
+	bullet.addComponent<CBoundingBox>(bullet.getComponent<CAnimation>().animation->getSize() * 0.90f);
 	bullet.addComponent<CDamage>(10);
-	bullet.addComponent<CState>("ALIVE");
+	bullet.addComponent<CState>(State::Alive);
 	bullet.addComponent<CLifespan>(45, m_currentFrame);
 }
 
 void Scene_Play::update()
 {
-	for (auto e : m_entityManager.getEntities("Enemy"))
+	for (auto e : m_entityManager.getEntities(Tag::Enemy))
 	{
 		if (e.isActive())
 		{
@@ -238,7 +270,6 @@ void Scene_Play::update()
 			m_currentFrame++;
 		}
 
-		sRender();
 		m_gameOver = true;
 	}
 	else
@@ -251,13 +282,59 @@ void Scene_Play::update()
 	}
 }
 
+// Tiles that live in m_staticGrid
+bool Scene_Play::isStaticCollider(Entity e)
+{
+	return (e.tag() == Tag::Tile || e.tag() == Tag::Destroyable) && e.hasComponent<CBoundingBox>();
+}
+
+// Entities that live in m_sceneryGrid
+bool Scene_Play::isScenery(Entity e)
+{
+	TagId tag = e.tag();
+	return tag == Tag::Tile || tag == Tag::Destroyable || tag == Tag::Decoration || tag == Tag::Ladder;
+}
+
+Vec2 Scene_Play::drawHalfSize(Entity e)
+{
+	auto& size = e.getComponent<CAnimation>().animation->getSize();
+	auto& scale = e.getComponent<CTransform>().scale;
+	return Vec2(size.x * std::fabs(scale.x) / 2.0f, size.y * std::fabs(scale.y) / 2.0f);
+}
+
+// World space rect the camera currently shows
+sf::FloatRect Scene_Play::viewBounds() const
+{
+	const sf::View& view = m_game->window().getView();
+	return sf::FloatRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+}
+
 void Scene_Play::sDragAndDrop()
 {
-	for (auto e : m_entityManager.getEntities())
+	for (auto e : m_entityManager.view<CTransform, CDraggable>())
 	{
-		if (e.hasComponent<CDraggable>() && e.getComponent<CDraggable>().dragging)
+		if (e.getComponent<CDraggable>().dragging)
 		{
-			e.getComponent<CTransform>().pos = windowToWorld(m_mPos);
+			// Keep the tile and scenery grids in sync with tiles being moved around
+			auto& transform = e.getComponent<CTransform>();
+			bool collider = isStaticCollider(e);
+			bool scenery = isScenery(e);
+
+			if (collider) { m_staticGrid.remove(e, transform.pos, e.getComponent<CBoundingBox>().halfSize); }
+			if (scenery)
+			{
+				m_sceneryGrid.remove(e, transform.pos, drawHalfSize(e));
+				m_tileChunks.remove(e, transform.pos);
+			}
+
+			transform.pos = windowToWorld(m_mPos);
+
+			if (collider) { m_staticGrid.insert(e, transform.pos, e.getComponent<CBoundingBox>().halfSize); }
+			if (scenery)
+			{
+				m_sceneryGrid.insert(e, transform.pos, drawHalfSize(e));
+				m_tileChunks.add(e, renderLayer(e));
+			}
 		}
 	}
 }
@@ -267,31 +344,32 @@ void Scene_Play::sDragAndDrop()
 /// </summary>
 void Scene_Play::sLifespan()
 {
-	for (auto e : m_entityManager.getEntities())
+	PROFILE_SYSTEM(m_stats, "sLifespan");
+	for (auto e : m_entityManager.view<CLifespan>())
 	{
-		if (e.hasComponent<CLifespan>())
+		if (m_currentFrame - e.getComponent<CLifespan>().frameCreated > e.getComponent<CLifespan>().lifespan)
 		{
-			if (m_currentFrame - e.getComponent<CLifespan>().frameCreated > e.getComponent<CLifespan>().lifespan)
-			{
-				e.destroy();
-			}
+			e.destroy();
 		}
+	}
 
-		if (e.hasComponent<CInvulnerable>())
+	for (auto e : m_entityManager.view<CInvulnerable>())
+	{
+		if (m_currentFrame - e.getComponent<CInvulnerable>().frameCreated > e.getComponent<CInvulnerable>().invulnerableFrames)
 		{
-			if (m_currentFrame - e.getComponent<CInvulnerable>().frameCreated > e.getComponent<CInvulnerable>().invulnerableFrames)
-			{
-				e.getComponent<CInvulnerable>().isInvulnerable = false;
-			}
+			e.getComponent<CInvulnerable>().isInvulnerable = false;
 		}
+	}
 
-		if (e.hasComponent<CAttacking>() && e.getComponent<CState>().state != "DEAD")
+	for (auto e : m_entityManager.view<CAttacking, CState, CTransform>())
+	{
+		if (e.getComponent<CState>().get() != State::Dead)
 		{
 			if (m_currentFrame - e.getComponent<CAttacking>().started > e.getComponent<CAttacking>().duration)
 			{
 				e.getComponent<CAttacking>().isAttacking = false;
 				e.getComponent<CTransform>().velocity.x = 0;
-				e.getComponent<CState>().state = "IDLE";
+				e.getComponent<CState>().set(State::Idle);
 
 				if (m_currentFrame - e.getComponent<CAttacking>().started > e.getComponent<CAttacking>().duration + e.getComponent<CAttacking>().coolDown)
 				{
@@ -304,14 +382,16 @@ void Scene_Play::sLifespan()
 
 void Scene_Play::sCamera()
 {
+	PROFILE_SYSTEM(m_stats, "sCamera");
 	float camYVelocity = 8.0f;
 	// TODO: Keep Camera on player unless player runs left / falls down a hole / enters a gate
 	// Set the viewport of the window to be centered on the player if it's far enough right
 	auto& pPos = m_player.getComponent<CTransform>().pos;
-	float windowCenterX = std::max(m_game->window().getSize().x / 2.0f, pPos.x);
-	float windowMaxY = m_game->window().getSize().y / 2.0f;
-	sf::View view = m_game->window().getView();
+	float windowCenterX = std::max(m_game->windowSize().x / 2.0f, pPos.x);
+	float windowMaxY = m_game->windowSize().y / 2.0f;
+	sf::View view = m_game->view();
 	float windowCenterY = view.getCenter().y;
+	m_prevCameraCenter = Vec2(view.getCenter().x, view.getCenter().y);
 
 	if (pPos.y < view.getCenter().y * 0.8f)
 	{
@@ -328,16 +408,17 @@ void Scene_Play::sCamera()
 	}
 
 	view.setCenter({ windowCenterX, windowCenterY });
-	m_game->window().setView(view);
+	m_game->setView(view);
 }
 
 void Scene_Play::sEnemyLogic()
 {
-	for (auto e : m_entityManager.getEntities("Enemy"))
+	PROFILE_SYSTEM(m_stats, "sEnemyLogic");
+	for (auto e : m_entityManager.getEntities(Tag::Enemy))
 	{
 		if (e.hasComponent<CAttacking>())
 		{
-			e.getComponent<CAttacking>().isInReach = (abs(m_player.getComponent<CTransform>().pos.x - e.getComponent<CTransform>().pos.x) < m_game->window().getView().getSize().x * 0.50f);
+			e.getComponent<CAttacking>().isInReach = (abs(m_player.getComponent<CTransform>().pos.x - e.getComponent<CTransform>().pos.x) < m_game->view().getSize().x * 0.50f);
 			e.getComponent<CTransform>().scale.x = (m_player.getComponent<CTransform>().pos.x < e.getComponent<CTransform>().pos.x) ? 1 : -1;
 
 			if (e.getComponent<CAttacking>().isInReach && e.getComponent<CAttacking>().attackType == "HITSCAN")
@@ -366,98 +447,104 @@ void Scene_Play::sEnemyLogic()
 					// Unsure of best way to implement custom enemy logic...
 					// Moves need to be timed and coordinated and bosses need "phases"
 					e.getComponent<CTransform>().velocity.x = 20 * -(e.getComponent<CTransform>().scale.x);
-					e.getComponent<CState>().state = "RUSH";
+					e.getComponent<CState>().set(State::Rush);
 				}
 			}
 		}
 	}
 }
 
-void Scene_Play::sStatus()
+// Plays the entity's clip for type. Entities without one (plain tiles, or blocks with no <Entity>Dead
+// clip) fall back to BulletDead so they still show something and get destroyed when it ends.
+void Scene_Play::playStateAnimation(CAnimation& animation, AnimationType type)
 {
-	// PLAYER STATES: Will need to conver this to an enum later
-	// - STANDING
-	// - JUMPING
-	// - RUNNING
-	// - SHOOTING
-	// - CROUCHING
+	AnimationEntityId entityId = animation.animation->getEntityId();
+	if (m_game->assets().hasAnimation(entityId, type))
+	{
+		animation.play(m_game->assets().getAnimation(entityId, type));
+		return;
+	}
 
-	// BULLET STATES:
-	// - LIVING
-	// - DYING // Dying takes time, set animation depending on frames for the animation, once the animation ends, sAnimation() calls destroy() on the entity
+	std::cout << "No animation of type " << (size_t)type << " for " << animation.animation->getName() << ", using BulletDead" << std::endl;
+	animation.play(m_game->assets().getAnimation("BulletDead"));
+}
 
-	// BLOCK STATES:
-	// - LIVING
-	// - DYING // Dying takes time, set animation depending on frames for the animation, once the animation ends, sAnimation() calls destroy() on the entity
+void Scene_Play::sStatus()
+{
+	PROFILE_SYSTEM(m_stats, "sStatus");
+	// Only entities whose state changed since the last frame do any work here.
+	// BULLET and BLOCK deaths take time - the dead animation plays out and sAnimation() destroys the entity when it ends
 
-	for (auto e : m_entityManager.getEntities())
+	for (auto e : m_entityManager.view<CState, CAnimation>())
 	{
-		if (e.hasComponent<CState>())
+		auto& state = e.getComponent<CState>();
+		if (!state.changed()) { continue; }
+		state.acknowledge();
+
+		auto& animation = e.getComponent<CAnimation>();
+		switch (state.get())
 		{
-			try
+		case State::Rush:
+			playStateAnimation(animation, AnimationType::Rush);
+			if (e.hasComponent<CAttacking>())
 			{
-				if (e.getComponent<CState>().state == "RUSH" && e.getComponent<CAnimation>().animation.getType() != "RUSH")
-				{
-					e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Rush");
-				}
-				else if (e.getComponent<CState>().state == "IDLE" && e.getComponent<CAnimation>().animation.getType() != "IDLE")
-				{
-					e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Idle");
-				}
-				else if (e.getComponent<CState>().state == "SHOOTING" && e.getComponent<CAnimation>().animation.getType() != "SHOOT")
-				{
-					// TODO
-					//e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Shoot");
-				}
-				else if (e.getComponent<CState>().state == "CROUCHING" && e.getComponent<CAnimation>().animation.getType() != "CROUCH")
-				{
-					// TODO
-					//e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Crouch");
-				}
-				else if (e.getComponent<CState>().state == "CLIMBING" && e.getComponent<CAnimation>().animation.getType() != "CLIMB")
-				{
-					// TODO
-					//e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Climb");
-				}
-				else if (e.getComponent<CState>().state == "JUMPING" && e.getComponent<CAnimation>().animation.getType() != "JUMP")
-				{
-					e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Jump");
-				}
-				else if (e.getComponent<CState>().state == "RUNNING" && e.getComponent<CAnimation>().animation.getType() != "RUN")
-				{
-					e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Run");
-				}
-				else if (e.getComponent<CState>().state == "DEAD" && e.getComponent<CAnimation>().animation.getType() != "DEAD")
-				{
-					// TODO: Create enemy death animation
-					e.getComponent<CAnimation>().animation = m_game->assets().getAnimation(e.getComponent<CAnimation>().animation.getEntityName() + "Dead");
-					e.getComponent<CAnimation>().repeat = false;
-					if (e.hasComponent<CTransform>())
-					{
-						e.getComponent<CTransform>().velocity = Vec2(0, 0);
-					}
-					if (e.hasComponent<CBoundingBox>())
-					{
-						e.getComponent<CBoundingBox>() = Vec2(0, 0);
-					}
-				}
+				e.getComponent<CAttacking>().duration = animation.animation->getDuration();
+			}
+			break;
+		case State::Idle:
+			playStateAnimation(animation, AnimationType::Idle);
+			break;
+		case State::Jumping:
+			playStateAnimation(animation, AnimationType::Jump);
+			break;
+		case State::Running:
+			playStateAnimation(animation, AnimationType::Run);
+			break;
+		case State::Shooting:
+		case State::Crouching:
+		case State::Climbing:
+			// TODO: Shoot, Crouch and Climb animations
+			break;
+		case State::Dead:
+		{
+			// The scenery grid holds it by its drawn size, which the death animation may change
+			Vec2 oldHalfSize = isScenery(e) ? drawHalfSize(e) : Vec2(0, 0);
 
-				if (e.hasComponent<CAttacking>() && e.getComponent<CAnimation>().animation.getType() == "RUSH")
-				{
-					e.getComponent<CAttacking>().duration = e.getComponent<CAnimation>().animation.getDuration();
-				}
+			// TODO: Create enemy death animation
+			playStateAnimation(animation, AnimationType::Dead);
+			animation.repeat = false;
+			if (e.hasComponent<CTransform>())
+			{
+				e.getComponent<CTransform>().velocity = Vec2(0, 0);
+			}
+			if (isStaticCollider(e))
+			{
+				m_staticGrid.remove(e, e.getComponent<CTransform>().pos, e.getComponent<CBoundingBox>().halfSize);
+			}
+			if (isScenery(e))
+			{
+				// Its death animation is drawn with the moving entities, so rebake its chunk without it.
+				// It stays in the scenery grid so the animation is still found on screen, until sAnimation destroys it.
+				auto& pos = e.getComponent<CTransform>().pos;
+				m_tileChunks.remove(e, pos);
+				m_sceneryGrid.remove(e, pos, oldHalfSize);
+				m_sceneryGrid.insert(e, pos, drawHalfSize(e));
 			}
-			catch (const std::exception& ex)
+			if (e.hasComponent<CBoundingBox>())
 			{
-				e.getComponent<CAnimation>().animation = m_game->assets().getAnimation("BulletDead");
-				std::cout << ex.what() << std::endl;
+				e.removeComponent<CBoundingBox>();
 			}
+			break;
+		}
+		default:
+			break;
 		}
 	}
 }
 
 void Scene_Play::sMovement()
 {
+	PROFILE_SYSTEM(m_stats, "sMovement");
 	if (m_pIsOnGround && !m_player.getComponent<CInput>().jump)
 	{
 		m_player.getComponent<CInput>().canJump = true;
@@ -469,104 +556,116 @@ void Scene_Play::sMovement()
 		m_player.getComponent<CInput>().canShoot = false;
 	}
 
-	for (auto e : m_entityManager.getEntities())
+	for (auto e : m_entityManager.view<CTransform, CGravity>())
 	{
 		// Before we do anything, make a copy of the entity's position
 		e.getComponent<CTransform>().prevPos = e.getComponent<CTransform>().pos;
 
-		if (e.hasComponent<CGravity>())
+		if (e.tag() == Tag::Player)
 		{
-			if (e.tag() == "Player")
+			// Player is colliding with a climbable object and is holding the "W" key to climb
+			if (e.getComponent<CInput>().canClimb && e.getComponent<CInput>().up)
 			{
-				// Player is colliding with a climbable object and is holding the "W" key to climb
-				if (e.getComponent<CInput>().canClimb && e.getComponent<CInput>().up)
-				{
-					e.getComponent<CState>().state = "CLIMBING";
-					e.getComponent<CTransform>().velocity.y = -5.0f;
-					e.getComponent<CTransform>().velocity.x = 0.0f;
-				}
-				else
+				e.getComponent<CState>().set(State::Climbing);
+				e.getComponent<CTransform>().velocity.y = -5.0f;
+				e.getComponent<CTransform>().velocity.x = 0.0f;
+			}
+			else
+			{
+				// SET PLAYER X-VELOCITY
+				if (e.getComponent<CInput>().right || e.getComponent<CInput>().left)
 				{
-					// SET PLAYER X-VELOCITY
-					if (e.getComponent<CInput>().right || e.getComponent<CInput>().left)
-					{
-						e.getComponent<CTransform>().velocity.x = e.getComponent<CInput>().right ? m_playerConfig.speedX : -m_playerConfig.speedX;
-						e.getComponent<CTransform>().scale.x = e.getComponent<CInput>().right ? 1 : -1;
-						if (m_pIsOnGround)
-						{
-							e.getComponent<CState>().state = "RUNNING";
-						}
-					}
-					else if (!e.getComponent<CInput>().right && !e.getComponent<CInput>().left)
+					e.getComponent<CTransform>().velocity.x = e.getComponent<CInput>().right ? m_playerConfig.speedX : -m_playerConfig.speedX;
+					e.getComponent<CTransform>().scale.x = e.getComponent<CInput>().right ? 1 : -1;
+					if (m_pIsOnGround)
 					{
-						e.getComponent<CTransform>().velocity.x = 0.0f;
-						if (m_pIsOnGround)
-						{
-							e.getComponent<CState>().state = "IDLE";
-						}
+						e.getComponent<CState>().set(State::Running);
 					}
-
-					// SET PLAYER Y-VELOCITY
-					if (e.getComponent<CInput>().jump && e.getComponent<CInput>().canJump && m_pIsOnGround)
-					{
-						e.getComponent<CTransform>().velocity.y = m_playerConfig.speedY;
-						e.getComponent<CState>().state = "JUMPING";
-						e.getComponent<CInput>().canJump = false;
-						m_pIsOnGround = false;
-					}
-					else if (!e.getComponent<CInput>().canJump && !m_pIsOnGround && e.getComponent<CInput>().jump)
-					{
-						e.getComponent<CTransform>().velocity.y += e.getComponent<CTransform>().velocity.y + e.getComponent<CGravity>().gravity;
-					}
-					else if (!e.getComponent<CInput>().canJump && !m_pIsOnGround && !e.getComponent<CInput>().jump)
-					{
-						e.getComponent<CTransform>().velocity.y += e.getComponent<CGravity>().gravity;
-					}
-					else
+				}
+				else if (!e.getComponent<CInput>().right && !e.getComponent<CInput>().left)
+				{
+					e.getComponent<CTransform>().velocity.x = 0.0f;
+					if (m_pIsOnGround)
 					{
-						e.getComponent<CTransform>().velocity.y += e.getComponent<CGravity>().gravity;
+						e.getComponent<CState>().set(State::Idle);
 					}
+				}
 
-					e.getComponent<CGravity>().gravity *= 1.1;
+				// SET PLAYER Y-VELOCITY
+				if (e.getComponent<CInput>().jump && e.getComponent<CInput>().canJump && m_pIsOnGround)
+				{
+					e.getComponent<CTransform>().velocity.y = m_playerConfig.speedY;
+					e.getComponent<CState>().set(State::Jumping);
+					e.getComponent<CInput>().canJump = false;
+					m_pIsOnGround = false;
+				}
+				else if (!e.getComponent<CInput>().canJump && !m_pIsOnGround && e.getComponent<CInput>().jump)
+				{
+					e.getComponent<CTransform>().velocity.y += e.getComponent<CTransform>().velocity.y + e.getComponent<CGravity>().gravity;
+				}
+				else if (!e.getComponent<CInput>().canJump && !m_pIsOnGround && !e.getComponent<CInput>().jump)
+				{
+					e.getComponent<CTransform>().velocity.y += e.getComponent<CGravity>().gravity;
+				}
+				else
+				{
+					e.getComponent<CTransform>().velocity.y += e.getComponent<CGravity>().gravity;
 				}
-			}
-			else
-			{
-				e.getComponent<CTransform>().velocity.y += e.getComponent<CGravity>().gravity;
-			}
-		}
 
-		// Cap entities speed in all directions using player's max speed (ideally entities should have their own max speed)
-		if (e.getComponent<CTransform>().velocity.x > m_playerConfig.maxSpeed)
-		{
-			e.getComponent<CTransform>().velocity.x = m_playerConfig.maxSpeed;
-		}
-		if (e.getComponent<CTransform>().velocity.x < -m_playerConfig.maxSpeed)
-		{
-			e.getComponent<CTransform>().velocity.x = -m_playerConfig.maxSpeed;
-		}
-		if (e.getComponent<CTransform>().velocity.y > m_playerConfig.maxSpeed)
-		{
-			e.getComponent<CTransform>().velocity.y = m_playerConfig.maxSpeed;
+				e.getComponent<CGravity>().gravity *= 1.1;
+			}
 		}
-		if (e.getComponent<CTransform>().velocity.y < -m_playerConfig.maxSpeed)
+		else
 		{
-			e.getComponent<CTransform>().velocity.y = -m_playerConfig.maxSpeed;
+			e.getComponent<CTransform>().velocity.y += e.getComponent<CGravity>().gravity;
 		}
 
+		applyVelocity(e.getComponent<CTransform>());
+	}
+
+	// Bullets don't have gravity, only their velocity needs to be applied
+	for (auto e : m_entityManager.getEntities(Tag::Bullet))
+	{
+		if (!e.isActive()) { continue; }
 
-		// Velocity has been managed, now update entity position using the updated volocity
-		e.getComponent<CTransform>().pos += e.getComponent<CTransform>().velocity;
+		e.getComponent<CTransform>().prevPos = e.getComponent<CTransform>().pos;
+		applyVelocity(e.getComponent<CTransform>());
 	}
 }
 
+void Scene_Play::applyVelocity(CTransform& transform)
+{
+	// Cap entities speed in all directions using player's max speed (ideally entities should have their own max speed)
+	if (transform.velocity.x > m_playerConfig.maxSpeed)
+	{
+		transform.velocity.x = m_playerConfig.maxSpeed;
+	}
+	if (transform.velocity.x < -m_playerConfig.maxSpeed)
+	{
+		transform.velocity.x = -m_playerConfig.maxSpeed;
+	}
+	if (transform.velocity.y > m_playerConfig.maxSpeed)
+	{
+		transform.velocity.y = m_playerConfig.maxSpeed;
+	}
+	if (transform.velocity.y < -m_playerConfig.maxSpeed)
+	{
+		transform.velocity.y = -m_playerConfig.maxSpeed;
+	}
+
+	// Velocity has been managed, now update entity position using the updated volocity
+	transform.pos += transform.velocity;
+}
+
 void Scene_Play::sCollision()
 {
+	PROFILE_SYSTEM(m_stats, "sCollision");
 	// Player collision with tiles
 	Vec2 overlap(0, 0);
 	auto& pPos = m_player.getComponent<CTransform>();
-	std::vector<std::string> tiles = { "Tile", "Destroyable" };
-	for (auto e : m_entityManager.getEntities(tiles))
+	m_nearby.clear();
+	m_staticGrid.query(pPos.pos, m_player.getComponent<CBoundingBox>().halfSize, m_nearby);
+	for (auto e : m_nearby)
 	{
 		overlap = Physics::GetOverlap(e, m_player);
 		// Collision detected
@@ -609,41 +708,63 @@ void Scene_Play::sCollision()
 				}
 			}
 		}
+	}
+
+	// Bullet collision with tiles
+	for (auto b : m_entityManager.getEntities(Tag::Bullet))
+	{
+		if (!b.hasComponent<CBoundingBox>()) { continue; }
 
-		for (auto b : m_entityManager.getEntities("Bullet"))
+		m_nearby.clear();
+		m_staticGrid.query(b.getComponent<CTransform>().pos, b.getComponent<CBoundingBox>().halfSize, m_nearby);
+		for (auto e : m_nearby)
 		{
 			overlap = Physics::GetOverlap(e, b);
 			if ((overlap.x > 0 && overlap.y > 0) && e.getComponent<CDestroyable>().has)
 			{
-				b.getComponent<CState>().state = "DEAD";
-				e.getComponent<CState>().state = "DEAD";
+				b.getComponent<CState>().set(State::Dead);
+				e.getComponent<CState>().set(State::Dead);
 			}
 			else if (overlap.x > 0 && overlap.y > 0)
 			{
-				b.getComponent<CState>().state = "DEAD";
+				b.getComponent<CState>().set(State::Dead);
 			}
 		}
 	}
 
-	for (auto b : m_entityManager.getEntities("Bullet"))
+	// Enemies move, so they're hashed again every frame
+	m_dynamicGrid.clear();
+	for (auto e : m_entityManager.getEntities(Tag::Enemy))
 	{
-		for (auto e : m_entityManager.getEntities("Enemy"))
+		if (e.hasComponent<CBoundingBox>())
+		{
+			m_dynamicGrid.insert(e, e.getComponent<CTransform>().pos, e.getComponent<CBoundingBox>().halfSize);
+		}
+	}
+
+	for (auto b : m_entityManager.getEntities(Tag::Bullet))
+	{
+		if (!b.hasComponent<CBoundingBox>()) { continue; }
+
+		m_nearby.clear();
+		m_dynamicGrid.query(b.getComponent<CTransform>().pos, b.getComponent<CBoundingBox>().halfSize, m_nearby);
+		for (auto e : m_nearby)
 		{
 			overlap = Physics::GetOverlap(b, e);
-			if ((overlap.x > 0 && overlap.y > 0) && b.getComponent<CState>().state != "DEAD")
+			if ((overlap.x > 0 && overlap.y > 0) && b.getComponent<CState>().get() != State::Dead)
 			{
-				b.getComponent<CState>().state = "DEAD";
+				b.getComponent<CState>().set(State::Dead);
 				e.getComponent<CHealth>().currentHealth -= b.getComponent<CDamage>().damage;
 
 				if (e.getComponent<CHealth>().currentHealth <= 0)
 				{
-					e.getComponent<CState>().state = "DEAD";
+					e.getComponent<CState>().set(State::Dead);
 				}
 			}
 		}
 	}
 
-	for (auto e : m_entityManager.getEntities("Ladder"))
+	for (auto e : m_entityManager.getEntities(Tag::Ladder))
 	{
 		overlap = Physics::GetOverlap(m_player, e);
 		if (overlap.x > 0 && overlap.y > 0)
@@ -658,7 +779,7 @@ void Scene_Play::sCollision()
 		}
 	}
 
-	for (auto e : m_entityManager.getEntities("Enemy"))
+	for (auto e : m_entityManager.getEntities(Tag::Enemy))
 	{
 		overlap = Physics::GetOverlap(m_player, e);
 		if ((overlap.x > 0 && overlap.y > 0) && !m_player.getComponent<CInvulnerable>().isInvulnerable)
@@ -671,9 +792,10 @@ void Scene_Play::sCollision()
 	}
 
 	// Not using bounding box here since we want the player to be off screen before we respawn them
-	if (m_player.getComponent<CTransform>().pos.y > m_game->window().getSize().y + m_player.getComponent<CAnimation>().animation.getSize().y)
+	if (m_player.getComponent<CTransform>().pos.y > m_game->windowSize().y + m_player.getComponent<CAnimation>().animation->getSize().y)
 	{
 		m_player.getComponent<CTransform>().pos = gridToMidPixel(m_playerConfig.gridX, m_playerConfig.gridY, m_player);
+		m_player.getComponent<CTransform>().prevPos = m_player.getComponent<CTransform>().pos;
 	}
 	// Player can not walk off the left side of the screen
 	if (m_player.getComponent<CTransform>().pos.x - m_player.getComponent<CBoundingBox>().halfSize.x < 0)
@@ -685,6 +807,7 @@ void Scene_Play::sCollision()
 	{
 		m_player.getComponent<CHealth>().currentHealth = m_player.getComponent<CHealth>().maxHealth;
 		m_player.getComponent<CTransform>().pos = gridToMidPixel(m_playerConfig.gridX, m_playerConfig.gridY, m_player);
+		m_player.getComponent<CTransform>().prevPos = m_player.getComponent<CTransform>().pos;
 	}
 }
 
@@ -696,6 +819,7 @@ void Scene_Play::sDoAction(const Action& action)
 		if (action.name() == "TOGGLE_TEXTURE")		{ m_drawTextures = !m_drawTextures; }
 		if (action.name() == "TOGGLE_COLLISION")	{ m_drawCollision = !m_drawCollision; }
 		if (action.name() == "TOGGLE_GRID")			{ m_drawGrid = !m_drawGrid; }
+		if (action.name() == "TOGGLE_STATS")		{ m_drawStats = !m_drawStats; }
 		if (action.name() == "PAUSE")				{ setPaused(!m_paused); }
 		if (action.name() == "QUIT")				{ onEnd(); }
 		if (action.name() == "CLIMB")				{ m_player.getComponent<CInput>().up = true; }
@@ -740,21 +864,20 @@ void Scene_Play::sDoAction(const Action& action)
 
 void Scene_Play::sDisplayHealth()
 {
-	std::vector<std::string> ents = { "Enemy", "Player" };
-	for (auto e : m_entityManager.getEntities(ents))
+	for (auto e : m_entityManager.getEntities({ Tag::Enemy, Tag::Player }))
 	{
-		if (e.tag() == "Enemy" && e.hasComponent<CHealth>())
+		if (e.tag() == Tag::Enemy && e.hasComponent<CHealth>())
 		{
 			if (e.getComponent<CHealth>().currentHealth < e.getComponent<CHealth>().maxHealth 
-				&& e.getComponent<CState>().state != "DEAD" 
+				&& e.getComponent<CState>().get() != State::Dead 
 				&& e.getComponent<CHealth>().currentHealth > 0)
 			{
-				auto entTrans = e.getComponent<CTransform>();
-				auto entSize = e.getComponent<CAnimation>().animation.getSize();
+				auto entPos = interpolate(e.getComponent<CTransform>());
+				auto entSize = e.getComponent<CAnimation>().animation->getSize();
 				auto rectBack = sf::RectangleShape({ entSize.x, 16 });
 				rectBack.setFillColor(sf::Color::Red);
 				// set the position to the middle of the entity (x) and slightly above the entity (-10)
-				rectBack.setPosition({ entTrans.pos.x - (entSize.x / 2), entTrans.pos.y - (entSize.y / 2) - 10});
+				rectBack.setPosition({ entPos.x - (entSize.x / 2), entPos.y - (entSize.y / 2) - 10});
 
 				auto rectFront = sf::RectangleShape({ entSize.x * (e.getComponent<CHealth>().currentHealth / e.getComponent<CHealth>().maxHealth), 16 });
 				rectFront.setFillColor(sf::Color::Green);
@@ -765,13 +888,13 @@ void Scene_Play::sDisplayHealth()
 			}
 		}
 
-		if (e.tag() == "Player" && e.hasComponent<CHealth>())
+		if (e.tag() == Tag::Player && e.hasComponent<CHealth>())
 		{
 			float offset = 32;
 			for (int i = 0; i < e.getComponent<CHealth>().currentHealth; i++)
 			{
 				auto spr = sf::Sprite(m_game->assets().getAnimation("HeartFull").getSprite());
-				auto pos = windowToWorld({ offset, 32 });
+				auto pos = windowToWorld({ offset, 32 }, m_game->window().getView());
 				spr.setPosition({ pos.x, pos.y });
 				m_game->window().draw(spr);
 
@@ -780,7 +903,7 @@ void Scene_Play::sDisplayHealth()
 			for (int i = 0; i < e.getComponent<CHealth>().maxHealth - e.getComponent<CHealth>().currentHealth; i++)
 			{
 				auto spr = sf::Sprite(m_game->assets().getAnimation("HeartEmpty").getSprite());
-				auto pos = windowToWorld({ offset, 32 });
+				auto pos = windowToWorld({ offset, 32 }, m_game->window().getView());
 				spr.setPosition({ pos.x, pos.y });
 				m_game->window().draw(spr);
 
@@ -792,41 +915,45 @@ void Scene_Play::sDisplayHealth()
 
 void Scene_Play::sAnimation()
 {
-	for (auto e : m_entityManager.getEntities())
+	PROFILE_SYSTEM(m_stats, "sAnimation");
+	for (auto e : m_entityManager.view<CAnimation>())
 	{
-		if (e.hasComponent<CAnimation>())
+		if (e.getComponent<CAnimation>().repeat)
 		{
-			if (e.getComponent<CAnimation>().repeat)
+			e.getComponent<CAnimation>().update();
+		}
+		else
+		{
+			if (e.getComponent<CAnimation>().hasEnded())
 			{
-				e.getComponent<CAnimation>().animation.update();
+				// Dead scenery would otherwise leave a stale handle in its grid cells
+				if (isScenery(e) && e.hasComponent<CTransform>())
+				{
+					m_sceneryGrid.remove(e, e.getComponent<CTransform>().pos, drawHalfSize(e));
+				}
+				e.destroy();
 			}
 			else
 			{
-				if (e.getComponent<CAnimation>().animation.hasEnded())
-				{
-					e.destroy();
-				}
-				else
-				{
-					e.getComponent<CAnimation>().animation.update();
-				}
+				e.getComponent<CAnimation>().update();
 			}
 		}
-		if (e.hasComponent<CInvulnerable>())
+	}
+
+	for (auto e : m_entityManager.view<CInvulnerable>())
+	{
+		if (e.getComponent<CInvulnerable>().isInvulnerable)
 		{
-			if (e.getComponent<CInvulnerable>().isInvulnerable)
-			{
-				// do shading of the current animation to show invulnverability
-			}
+			// do shading of the current animation to show invulnverability
 		}
 	}
 }
 
 void Scene_Play::sRayCast()
 {
-	for (auto e : m_entityManager.getEntities())
+	for (auto e : m_entityManager.view<CRayCaster, CAttacking>())
 	{
-		if (e.hasComponent<CRayCaster>() && e.getComponent<CAttacking>().isInReach)
+		if (e.getComponent<CAttacking>().isInReach)
 		{
 			for (auto t : e.getComponent<CRayCaster>().targets)
 			{
@@ -846,89 +973,157 @@ void Scene_Play::sRayCast()
 
 void Scene_Play::sRender()
 {
+	PROFILE_SYSTEM(m_stats, "sRender");
 	// Color the background darker so you know that the game is paused
 	if (!m_paused) { m_game->window().clear(sf::Color(0xa83e75)); }
 	else { m_game->window().clear(sf::Color(0xa83ea8)); }
 
+	// Draw the camera and everything that moves part way between the last two simulation ticks.
+	// The real view is put back at the end so the simulation never sees the interpolated one.
+	const sf::View& cameraView = m_game->view();
+	sf::View renderView = cameraView;
+	Vec2 cameraCenter(cameraView.getCenter().x, cameraView.getCenter().y);
+	Vec2 renderCenter = m_prevCameraCenter + (cameraCenter - m_prevCameraCenter) * m_interpolation;
+	renderView.setCenter({ renderCenter.x, renderCenter.y });
+	m_game->window().setView(renderView);
+
+	// Only entities overlapping the camera are drawn. Scenery is looked up in m_sceneryGrid so the
+	// cost doesn't grow with the length of the level.
+	sf::FloatRect view = viewBounds();
+	Vec2 viewHalfSize(view.size.x / 2.0f, view.size.y / 2.0f);
+	m_visible.clear();
+	m_sceneryGrid.query(Vec2(view.position.x, view.position.y) + viewHalfSize, viewHalfSize, m_visible);
+	size_t drawCalls = 0;
+
 	// Draw all Entity textures + animations
 	if (m_drawTextures)
 	{
 		sRayCast();
-		for (auto e : m_entityManager.getEntities())
+		m_spriteBatch.clear();
+		for (auto e : m_visible)
 		{
-			auto& transform = e.getComponent<CTransform>();
+			// Baked scenery is drawn by m_tileChunks
+			if (TileChunkCache::isBakeable(e)) { continue; }
 
-			if (e.hasComponent<CAnimation>())
+			if (e.hasComponent<CAnimation>() && Physics::GetDrawBounds(e).findIntersection(view))
+			{
+				m_spriteBatch.add(e.getComponent<CAnimation>(), e.getComponent<CTransform>(), renderLayer(e));
+			}
+		}
+		for (auto e : m_entityManager.getEntities({ Tag::Default, Tag::Player, Tag::Enemy, Tag::Bullet }))
+		{
+			if (e.hasComponent<CAnimation>() && e.hasComponent<CTransform>() && Physics::GetDrawBounds(e).findIntersection(view))
 			{
-				auto& animation = e.getComponent<CAnimation>().animation;
-				animation.getSprite().setRotation(sf::degrees(transform.angle));
-				animation.getSprite().setPosition({ transform.pos.x, transform.pos.y });
-				animation.getSprite().setScale({ transform.scale.x, transform.scale.y });
-				m_game->window().draw(animation.getSprite());
+				auto& transform = e.getComponent<CTransform>();
+				m_spriteBatch.add(e.getComponent<CAnimation>(), transform, interpolate(transform), renderLayer(e));
 			}
 		}
+		m_tileChunks.prepare(view);
+		for (uint8_t layer = 0; layer < RENDER_LAYER_COUNT; ++layer)
+		{
+			drawCalls += m_tileChunks.draw(m_game->window(), layer);
+			drawCalls += m_spriteBatch.draw(m_game->window(), layer);
+		}
 		sDisplayHealth();
 	}
 
 	// Draw all Entity collision bounding boxes with a rectangleShape
 	if (m_drawCollision)
 	{
-		for (auto e : m_entityManager.getEntities())
+		auto drawBox = [&](Entity e)
 		{
-			if (e.hasComponent<CBoundingBox>())
-			{
-				auto& box = e.getComponent<CBoundingBox>();
-				auto& transform = e.getComponent<CTransform>();
-				sf::RectangleShape rect;
-				rect.setSize(sf::Vector2f(box.size.x - 1, box.size.y - 1));
-				rect.setOrigin(sf::Vector2f(box.halfSize.x, box.halfSize.y));
-				rect.setPosition({ transform.pos.x, transform.pos.y });
-				rect.setFillColor(sf::Color(0, 0, 0, 0));
-				rect.setOutlineColor(sf::Color(255, 255, 255, 255));
-				rect.setOutlineThickness(1);
-				m_game->window().draw(rect);
-			}
+			auto& box = e.getComponent<CBoundingBox>();
+			Vec2 pos = interpolate(e.getComponent<CTransform>());
+			sf::FloatRect bounds({ pos.x - box.halfSize.x, pos.y - box.halfSize.y }, { box.size.x, box.size.y });
+			if (!bounds.findIntersection(view)) { return; }
+
+			sf::RectangleShape rect;
+			rect.setSize(sf::Vector2f(box.size.x - 1, box.size.y - 1));
+			rect.setOrigin(sf::Vector2f(box.halfSize.x, box.halfSize.y));
+			rect.setPosition({ pos.x, pos.y });
+			rect.setFillColor(sf::Color(0, 0, 0, 0));
+			rect.setOutlineColor(sf::Color(255, 255, 255, 255));
+			rect.setOutlineThickness(1);
+			m_game->window().draw(rect);
+		};
+
+		for (auto e : m_visible)
+		{
+			if (e.hasComponent<CBoundingBox>()) { drawBox(e); }
+		}
+		for (auto e : m_entityManager.getEntities({ Tag::Default, Tag::Player, Tag::Enemy, Tag::Bullet }))
+		{
+			if (e.hasComponent<CBoundingBox>() && e.hasComponent<CTransform>()) { drawBox(e); }
 		}
 	}
 
 	if (m_drawGrid)
 	{
-		float leftX = m_game->window().getView().getCenter().x - width() / 2;
-		float rightX = leftX + width() + m_gridSize.x;
-		float nextGridX = leftX - ((int)leftX % (int)m_gridSize.x);
+		// Row 0 sits on the bottom of the window, like the level's grid coordinates
+		m_gridOverlay.draw(m_game->window(), (float)height());
+	}
+	m_mouseShape.setFillColor(sf::Color(255, 0, 0));
+	m_mouseShape.setRadius(4);
+	m_mouseShape.setOrigin({ 2, 2 });
+	Vec2 worldPos = windowToWorld(m_mPos, renderView);
+	m_mouseShape.setPosition({ worldPos.x, worldPos.y });
+	m_game->window().draw(m_mouseShape);
 
-		for (float x = nextGridX; x < rightX; x += m_gridSize.x)
+	if (m_drawStats)
+	{
+		// Draw calls only counts the sprite batches and tile chunks, which is nearly all of them
+		auto& pool = EntityMemoryPool::Instance();
+		m_stats.setCounter("Entities", m_entityManager.getEntities().size());
+		m_stats.setCounter("Enemies", m_entityManager.getEntities(Tag::Enemy).size());
+		m_stats.setCounter("Bullets", m_entityManager.getEntities(Tag::Bullet).size());
+		m_stats.setCounter("Scenery on screen", m_visible.size());
+		m_stats.setCounter("Batched draw calls", drawCalls);
+		m_stats.setCounter("Entity pool", std::to_string(pool.size()) + " / " + std::to_string(pool.capacity()));
+		m_stats.draw(m_game->window());
+	}
+
+	m_game->window().setView(cameraView);
+}
+
+// FNV-1a over everything update() moves, in entity order
+uint64_t Scene_Play::stateChecksum() const
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* data, size_t size)
+	{
+		auto bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
 		{
-			drawLine(Vec2(x, 0.0f), Vec2(x, (float)height()));
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
 		}
+	};
 
-		for (float y = 0; y < height(); y += m_gridSize.y)
-		{
-			drawLine(Vec2(leftX, height() - y), Vec2(rightX, height() - y));
+	mix(&m_currentFrame, sizeof(m_currentFrame));
+	for (auto e : m_entityManager.view<CTransform>())
+	{
+		auto& transform = e.getComponent<CTransform>();
+		float values[] = { transform.pos.x, transform.pos.y, transform.velocity.x, transform.velocity.y, transform.scale.x };
+		mix(values, sizeof(values));
 
-			for (float x = nextGridX; x < rightX; x += m_gridSize.x)
-			{
-				std::string xCell = std::to_string((int)x / (int)m_gridSize.x);
-				std::string yCell = std::to_string((int)y / (int)m_gridSize.y);
-				m_gridText.setString("(" + xCell + "," + yCell + ")");
-				m_gridText.setPosition({ x + 3, height() - y - m_gridSize.y + 2 });
-				m_game->window().draw(m_gridText);
-			}
+		if (e.hasComponent<CHealth>())
+		{
+			mix(&e.getComponent<CHealth>().currentHealth, sizeof(float));
 		}
 	}
-	m_mouseShape.setFillColor(sf::Color(255, 0, 0));
-	m_mouseShape.setRadius(4);
-	m_mouseShape.setOrigin({ 2, 2 });
-	Vec2 worldPos = windowToWorld(m_mPos);
-	m_mouseShape.setPosition({ worldPos.x, worldPos.y });
-	m_game->window().draw(m_mouseShape);
+
+	return hash;
 }
 
 void Scene_Play::onEnd()
 {
 	m_hasEnded = true;
-	sf::View view = m_game->window().getView();
-	view.setCenter({ m_game->window().getSize().x / 2.0f, m_game->window().getSize().y / 2.0f });
-	m_game->window().setView(view);
+	stopRecording();
+	sf::View view = m_game->view();
+	view.setCenter({ m_game->windowSize().x / 2.0f, m_game->windowSize().y / 2.0f });
+	m_game->setView(view);
+
+	// There's no menu to go back to in a headless run, which stops when the scene ends
+	if (m_game->isHeadless()) { return; }
+
 	m_game->changeScene("MENU", nullptr, true);
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include "Scene.h"
 #include "EntityManager.h"
+#include "GridOverlay.h"
+#include "SpatialHash.h"
+#include "StatsOverlay.h"
+#include "TileChunkCache.h"
 
 #include <map>
 #include <memory>
@@ -33,14 +37,24 @@ protected:
 	bool								m_drawTextures = true;
 	bool								m_drawCollision = false;
 	bool								m_drawGrid = false;
+	bool								m_drawStats = false;
 	const Vec2							m_gridSize = { 64, 64 };
-	sf::Text							m_gridText;
+	GridOverlay							m_gridOverlay;
+	StatsOverlay						m_stats;					// Performance overlay (F3), systems report to it through PROFILE_SYSTEM
+	SpatialHash							m_staticGrid;				// Tiles, built once in loadLevel
+	SpatialHash							m_dynamicGrid;				// Moving entities, rebuilt every frame
+	SpatialHash							m_sceneryGrid;				// Everything loaded from the level that isn't a character, by drawn bounds
+	std::vector<Entity>					m_nearby;					// Scratch buffer for spatial queries
+	std::vector<Entity>					m_visible;					// Scenery on screen this frame
+	TileChunkCache						m_tileChunks;				// Scenery that doesn't animate, baked at load
 
 	Vec2								m_mPos;
+	Vec2								m_prevCameraCenter;			// View center before the last sCamera, for interpolation
 	sf::CircleShape						m_mouseShape;
 
 	Vec2 gridToMidPixel(float gridX, float gridY, Entity);
 	Vec2 windowToWorld(const Vec2& windowPos) const;
+	Vec2 windowToWorld(const Vec2& windowPos, const sf::View& view) const;
 
 	void init(const std::string& levelPath);
 	void loadLevel(const std::string& filename);
@@ -50,6 +64,12 @@ protected:
 	void spawnPlayer();
 	void spawnEnemy(EnemyConfig& enemy);
 	void spawnBullet(Entity entity);
+	void applyVelocity(CTransform& transform);
+	void playStateAnimation(CAnimation& animation, AnimationType type);
+	bool isStaticCollider(Entity e);
+	bool isScenery(Entity e);
+	Vec2 drawHalfSize(Entity e);
+	sf::FloatRect viewBounds() const;
 
 	void sAnimation();
 	void sCamera();
@@ -67,4 +87,5 @@ public:
 	Scene_Play(GameEngine* gameEngine, const std::string& levelPath);
 
 	void sRender();
+	uint64_t stateChecksum() const;
 };
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(const Vec2& cellSize) :
+	m_cellSize(cellSize)
+{
+
+}
+
+uint64_t SpatialHash::key(int x, int y) const
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+void SpatialHash::cellRange(const Vec2& pos, const Vec2& halfSize, int& minX, int& minY, int& maxX, int& maxY) const
+{
+	minX = (int)std::floor((pos.x - halfSize.x) / m_cellSize.x);
+	minY = (int)std::floor((pos.y - halfSize.y) / m_cellSize.y);
+	maxX = (int)std::floor((pos.x + halfSize.x) / m_cellSize.x);
+	maxY = (int)std::floor((pos.y + halfSize.y) / m_cellSize.y);
+}
+
+void SpatialHash::clear()
+{
+	// Keep the buckets around, moving entities are re-inserted into mostly the same cells every frame
+	for (auto& cell : m_cells)
+	{
+		cell.second.clear();
+	}
+}
+
+void SpatialHash::insert(Entity e, const Vec2& pos, const Vec2& halfSize)
+{
+	int minX, minY, maxX, maxY;
+	cellRange(pos, halfSize, minX, minY, maxX, maxY);
+
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			m_cells[key(x, y)].push_back(e);
+		}
+	}
+}
+
+void SpatialHash::remove(Entity e, const Vec2& pos, const Vec2& halfSize)
+{
+	int minX, minY, maxX, maxY;
+	cellRange(pos, halfSize, minX, minY, maxX, maxY);
+
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			auto it = m_cells.find(key(x, y));
+			if (it == m_cells.end()) { continue; }
+
+			auto& cell = it->second;
+			cell.erase(std::remove(cell.begin(), cell.end(), e), cell.end());
+		}
+	}
+}
+
+void SpatialHash::query(const Vec2& pos, const Vec2& halfSize, std::vector<Entity>& out) const
+{
+	int minX, minY, maxX, maxY;
+	cellRange(pos, halfSize, minX, minY, maxX, maxY);
+
+	size_t first = out.size();
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			auto it = m_cells.find(key(x, y));
+			if (it == m_cells.end()) { continue; }
+
+			for (auto e : it->second)
+			{
+				// Entities spanning several cells are only reported once. Queries cover a handful of cells
+				// so a linear search beats anything fancier.
+				if (std::find(out.begin() + first, out.end(), e) == out.end())
+				{
+					out.push_back(e);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Entity.h"
+#include "Vec2.h"
+
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Uniform grid of fixed size cells, hashed by cell coordinate so the level doesn't need known bounds.
+// Entities are bucketed into every cell their AABB touches, so a query only looks at the entities
+// in the few cells around the area being tested instead of every entity in the level.
+class SpatialHash
+{
+	std::unordered_map<uint64_t, std::vector<Entity>>	m_cells;
+	Vec2												m_cellSize = { 64, 64 };
+
+	uint64_t key(int x, int y) const;
+	void cellRange(const Vec2& pos, const Vec2& halfSize, int& minX, int& minY, int& maxX, int& maxY) const;
+
+public:
+	SpatialHash() {}
+	SpatialHash(const Vec2& cellSize);
+
+	void clear();
+	void insert(Entity e, const Vec2& pos, const Vec2& halfSize);
+	void remove(Entity e, const Vec2& pos, const Vec2& halfSize);
+
+	// Appends every entity whose cells overlap the AABB to out, each entity at most once.
+	// Entities are returned as inserted - destroyed entities are left to the caller to skip.
+	void query(const Vec2& pos, const Vec2& halfSize, std::vector<Entity>& out) const;
+};
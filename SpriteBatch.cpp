@@ -0,0 +1,141 @@
+#include "SpriteBatch.h"
+
+#include <cassert>
+#include <cmath>
+
+SpriteBatch::Batch& SpriteBatch::getBatch(uint8_t layer, const sf::Texture& texture)
+{
+	if (layer >= m_layers.size())
+	{
+		m_layers.resize(layer + 1);
+	}
+
+	Layer& l = m_layers[layer];
+	auto it = l.batchIndex.find(&texture);
+	if (it != l.batchIndex.end())
+	{
+		return l.batches[it->second];
+	}
+
+	// First sprite with this texture on this layer this frame - reuse the next free batch so its
+	// vertex storage doesn't have to grow again
+	if (l.used == l.batches.size())
+	{
+		l.batches.emplace_back();
+	}
+
+	Batch& batch = l.batches[l.used];
+	batch.texture = &texture;
+	batch.vertices.clear();
+	l.batchIndex[&texture] = l.used;
+	l.used++;
+	return batch;
+}
+
+void SpriteBatch::clear()
+{
+	for (auto& layer : m_layers)
+	{
+		layer.used = 0;
+		layer.batchIndex.clear();
+	}
+	m_spriteCount = 0;
+}
+
+void SpriteBatch::add(const sf::Texture& texture, const sf::IntRect& textureRect, const Vec2& origin,
+	const Vec2& pos, const Vec2& scale, float angle, uint8_t layer)
+{
+	Batch& batch = getBatch(layer, texture);
+
+	// Same transform sf::Sprite would apply: origin, then scale, then rotation, then position
+	float radians = angle * 3.14159265f / 180.0f;
+	float c = std::cos(radians);
+	float s = std::sin(radians);
+
+	auto toWorld = [&](float x, float y) -> sf::Vector2f
+	{
+		float sx = (x - origin.x) * scale.x;
+		float sy = (y - origin.y) * scale.y;
+		return { pos.x + sx * c - sy * s, pos.y + sx * s + sy * c };
+	};
+
+	float w = (float)textureRect.size.x;
+	float h = (float)textureRect.size.y;
+	float left = (float)textureRect.position.x;
+	float top = (float)textureRect.position.y;
+
+	sf::Vertex topLeft{ toWorld(0, 0), sf::Color::White, { left, top } };
+	sf::Vertex topRight{ toWorld(w, 0), sf::Color::White, { left + w, top } };
+	sf::Vertex bottomLeft{ toWorld(0, h), sf::Color::White, { left, top + h } };
+	sf::Vertex bottomRight{ toWorld(w, h), sf::Color::White, { left + w, top + h } };
+
+	batch.vertices.append(topLeft);
+	batch.vertices.append(topRight);
+	batch.vertices.append(bottomLeft);
+	batch.vertices.append(bottomLeft);
+	batch.vertices.append(topRight);
+	batch.vertices.append(bottomRight);
+	m_spriteCount++;
+}
+
+void SpriteBatch::add(const CAnimation& animation, const CTransform& transform, uint8_t layer)
+{
+	add(animation, transform, transform.pos, layer);
+}
+
+// Draws at pos instead of the transform's position, e.g. when interpolating between simulation ticks
+void SpriteBatch::add(const CAnimation& animation, const CTransform& transform, const Vec2& pos, uint8_t layer)
+{
+	const Vec2& size = animation.animation->getSize();
+	add(animation.animation->getTexture(), animation.getTextureRect(), Vec2(size.x / 2.0f, size.y / 2.0f),
+		pos, transform.scale, transform.angle, layer);
+}
+
+size_t SpriteBatch::draw(sf::RenderTarget& target)
+{
+	size_t drawCalls = 0;
+	for (size_t layer = 0; layer < m_layers.size(); ++layer)
+	{
+		drawCalls += draw(target, (uint8_t)layer);
+	}
+	return drawCalls;
+}
+
+size_t SpriteBatch::draw(sf::RenderTarget& target, uint8_t layer)
+{
+	if (layer >= m_layers.size()) { return 0; }
+
+	Layer& l = m_layers[layer];
+	for (size_t i = 0; i < l.used; ++i)
+	{
+		target.draw(l.batches[i].vertices, sf::RenderStates(l.batches[i].texture));
+	}
+	return l.used;
+}
+
+size_t SpriteBatch::spriteCount() const
+{
+	return m_spriteCount;
+}
+
+size_t SpriteBatch::layerCount() const
+{
+	return m_layers.size();
+}
+
+size_t SpriteBatch::batchCount(uint8_t layer) const
+{
+	return layer < m_layers.size() ? m_layers[layer].used : 0;
+}
+
+const sf::Texture& SpriteBatch::batchTexture(uint8_t layer, size_t batch) const
+{
+	assert(batch < batchCount(layer));
+	return *m_layers[layer].batches[batch].texture;
+}
+
+const sf::VertexArray& SpriteBatch::batchVertices(uint8_t layer, size_t batch) const
+{
+	assert(batch < batchCount(layer));
+	return m_layers[layer].batches[batch].vertices;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Components.h"
+
+#include <SFML/Graphics.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Collects sprites for a frame and draws them with one vertex array draw per texture per layer.
+// Layers are drawn in increasing order. Within a layer, sprites sharing a texture are drawn in the
+// order they were added and textures are drawn in the order they were first seen.
+class SpriteBatch
+{
+	struct Batch
+	{
+		const sf::Texture*	texture = nullptr;
+		sf::VertexArray		vertices = sf::VertexArray(sf::PrimitiveType::Triangles);
+	};
+
+	struct Layer
+	{
+		std::vector<Batch>										batches;
+		std::unordered_map<const sf::Texture*, size_t>			batchIndex;
+		size_t													used = 0;		// Batches holding sprites this frame
+	};
+
+	std::vector<Layer>		m_layers;
+	size_t					m_spriteCount = 0;
+
+	Batch& getBatch(uint8_t layer, const sf::Texture& texture);
+
+public:
+	SpriteBatch() {}
+
+	// Empties the batch but keeps the vertex storage for the next frame
+	void clear();
+	void add(const sf::Texture& texture, const sf::IntRect& textureRect, const Vec2& origin,
+		const Vec2& pos, const Vec2& scale, float angle, uint8_t layer);
+	void add(const CAnimation& animation, const CTransform& transform, uint8_t layer);
+	void add(const CAnimation& animation, const CTransform& transform, const Vec2& pos, uint8_t layer);
+
+	// Both return the number of draw calls issued
+	size_t draw(sf::RenderTarget& target);
+	size_t draw(sf::RenderTarget& target, uint8_t layer);
+
+	size_t spriteCount() const;
+
+	// The vertices built so far, for callers that keep them on the GPU instead of drawing them each frame
+	size_t layerCount() const;
+	size_t batchCount(uint8_t layer) const;
+	const sf::Texture& batchTexture(uint8_t layer, size_t batch) const;
+	const sf::VertexArray& batchVertices(uint8_t layer, size_t batch) const;
+};
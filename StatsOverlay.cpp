@@ -0,0 +1,104 @@
+#include "StatsOverlay.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+StatsOverlay::StatsOverlay(const sf::Font& font, unsigned int characterSize) :
+	m_text(font, "", characterSize)
+{
+	m_text.setFillColor(sf::Color::White);
+	m_text.setOutlineColor(sf::Color::Black);
+	m_text.setOutlineThickness(1);
+	m_background.setFillColor(sf::Color(0, 0, 0, 160));
+}
+
+// system should be a string literal, systems are told apart by pointer first since that's what they'll almost always match on
+void StatsOverlay::addTime(const char* system, float milliseconds)
+{
+	auto it = std::find_if(m_systems.begin(), m_systems.end(), [system](const SystemTime& s)
+	{
+		return s.name == system || std::strcmp(s.name, system) == 0;
+	});
+
+	if (it == m_systems.end())
+	{
+		m_systems.emplace_back();
+		m_systems.back().name = system;
+		it = m_systems.end() - 1;
+	}
+
+	it->samples[it->next] = milliseconds;
+	it->next = (it->next + 1) % SAMPLES;
+	it->count = std::min(it->count + 1, SAMPLES);
+}
+
+void StatsOverlay::setCounter(const std::string& name, const std::string& value)
+{
+	for (auto& counter : m_counters)
+	{
+		if (counter.first == name)
+		{
+			counter.second = value;
+			return;
+		}
+	}
+	m_counters.push_back({ name, value });
+}
+
+void StatsOverlay::setCounter(const std::string& name, size_t value)
+{
+	setCounter(name, std::to_string(value));
+}
+
+void StatsOverlay::refreshText()
+{
+	// The fonts aren't monospaced, so no attempt at columns
+	std::string text;
+	char line[96];
+	for (auto& system : m_systems)
+	{
+		float total = 0, peak = 0;
+		for (size_t i = 0; i < system.count; i++)
+		{
+			total += system.samples[i];
+			peak = std::max(peak, system.samples[i]);
+		}
+		float average = system.count ? total / system.count : 0;
+
+		std::snprintf(line, sizeof(line), "%s: %.3f ms avg, %.3f max\n", system.name, average, peak);
+		text += line;
+	}
+
+	text += "\n";
+	for (auto& counter : m_counters)
+	{
+		text += counter.first + ": " + counter.second + "\n";
+	}
+
+	m_text.setString(text);
+	sf::FloatRect bounds = m_text.getLocalBounds();
+	m_background.setSize({ bounds.position.x + bounds.size.x + 20, bounds.position.y + bounds.size.y + 20 });
+}
+
+void StatsOverlay::draw(sf::RenderTarget& target)
+{
+	if (m_framesUntilRefresh == 0)
+	{
+		refreshText();
+		m_framesUntilRefresh = REFRESH_FRAMES;
+	}
+	m_framesUntilRefresh--;
+
+	sf::View view = target.getView();
+	target.setView(target.getDefaultView());
+
+	// Top right, out of the way of the health hearts
+	float x = target.getSize().x - m_background.getSize().x - 10;
+	m_background.setPosition({ x, 10 });
+	m_text.setPosition({ x + 10, 20 });
+	target.draw(m_background);
+	target.draw(m_text);
+
+	target.setView(view);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// The performance overlay (F3): how long each system took on average and at worst over the last
+// SAMPLES runs, plus whatever counters the scene reports for the frame. Systems add their times
+// through PROFILE_SYSTEM (see Profiler.h), which is cheap enough to leave on when the overlay is hidden.
+class StatsOverlay
+{
+	static constexpr size_t SAMPLES = 60;
+	static constexpr size_t REFRESH_FRAMES = 15;		// Rebuilding the text every frame would only make it unreadable
+
+	struct SystemTime
+	{
+		const char*					name = nullptr;
+		std::array<float, SAMPLES>	samples = {};		// Milliseconds, a ring buffer of the last SAMPLES runs
+		size_t						next = 0;
+		size_t						count = 0;
+	};
+
+	std::vector<SystemTime>								m_systems;			// In the order they first reported
+	std::vector<std::pair<std::string, std::string>>	m_counters;			// Set each frame by the scene
+	sf::Text											m_text;
+	sf::RectangleShape									m_background;
+	size_t												m_framesUntilRefresh = 0;
+
+	void refreshText();
+
+public:
+	StatsOverlay(const sf::Font& font, unsigned int characterSize);
+
+	void addTime(const char* system, float milliseconds);
+	void setCounter(const std::string& name, const std::string& value);
+	void setCounter(const std::string& name, size_t value);
+
+	// Drawn in window coordinates, target's view is left as it was
+	void draw(sf::RenderTarget& target);
+};
+
+// Adds the time between its construction and destruction to a StatsOverlay, see PROFILE_SYSTEM
+class SystemTimer
+{
+	StatsOverlay&									m_stats;
+	const char*										m_name;
+	std::chrono::steady_clock::time_point			m_start;
+
+public:
+	SystemTimer(StatsOverlay& stats, const char* name) :
+		m_stats(stats), m_name(name), m_start(std::chrono::steady_clock::now())
+	{
+	}
+
+	~SystemTimer()
+	{
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+		m_stats.addTime(m_name, elapsed.count());
+	}
+};
@@ -0,0 +1,40 @@
+#include "Tags.h"
+
+#include <cassert>
+
+TagRegistry::TagRegistry()
+{
+	// Must match the order of the Tag enum
+	const char* builtIn[] = { "Default", "Player", "Enemy", "Tile", "Destroyable", "Decoration", "Ladder", "Bullet" };
+	static_assert(sizeof(builtIn) / sizeof(builtIn[0]) == Tag::Count, "Tag enum and built-in tag names are out of sync");
+
+	for (const char* name : builtIn)
+	{
+		intern(name);
+	}
+}
+
+TagId TagRegistry::intern(const std::string& name)
+{
+	auto it = m_ids.find(name);
+	if (it != m_ids.end())
+	{
+		return it->second;
+	}
+
+	TagId id = (TagId)m_names.size();
+	m_names.push_back(name);
+	m_ids[name] = id;
+	return id;
+}
+
+const std::string& TagRegistry::getName(TagId id) const
+{
+	assert(id < m_names.size());
+	return m_names[id];
+}
+
+size_t TagRegistry::size() const
+{
+	return m_names.size();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+typedef uint16_t TagId;
+
+// Tags the code refers to directly. They are interned first, in this order, so the ids are
+// known at compile time and tag checks in systems are integer compares, e.g. e.tag() == Tag::Player
+namespace Tag
+{
+	enum : TagId
+	{
+		Default,
+		Player,
+		Enemy,
+		Tile,
+		Destroyable,
+		Decoration,
+		Ladder,
+		Bullet,
+		Count
+	};
+}
+
+// Interns tag names (e.g. from level files) to small integer ids
+class TagRegistry
+{
+	std::vector<std::string>						m_names;			// Tag id -> name
+	std::unordered_map<std::string, TagId>			m_ids;				// Name -> tag id
+
+	TagRegistry();
+
+public:
+
+	static TagRegistry& Instance()
+	{
+		static TagRegistry registry;
+		return registry;
+	}
+
+	TagId intern(const std::string& name);
+	const std::string& getName(TagId id) const;
+	size_t size() const;
+};
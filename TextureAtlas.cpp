@@ -0,0 +1,219 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+void TextureAtlas::setUpload(bool upload)
+{
+	m_upload = upload;
+}
+
+void TextureAtlas::setKeepPixels(bool keep)
+{
+	m_keepPixels = keep;
+}
+
+void TextureAtlas::add(const std::string& name, sf::Image image, bool smooth)
+{
+	sf::IntRect rect({ 0, 0 }, { (int)image.getSize().x, (int)image.getSize().y });
+	add(name, std::make_shared<const sf::Image>(std::move(image)), rect, smooth);
+}
+
+// The source is kept alive until build(), so callers can hand over a whole sheet and a rect per tile
+void TextureAtlas::add(const std::string& name, std::shared_ptr<const sf::Image> source, const sf::IntRect& sourceRect, bool smooth)
+{
+	if (sourceRect.size.x <= 0 || sourceRect.size.y <= 0) { return; }
+
+	if (sourceRect.position.x < 0 || sourceRect.position.y < 0 ||
+		(unsigned int)(sourceRect.position.x + sourceRect.size.x) > source->getSize().x ||
+		(unsigned int)(sourceRect.position.y + sourceRect.size.y) > source->getSize().y)
+	{
+		std::cerr << "Could not copy " << name << " out of its source image" << std::endl;
+		return;
+	}
+
+	if (sourceRect.size.x + PADDING * 2 > PAGE_SIZE || sourceRect.size.y + PADDING * 2 > PAGE_SIZE)
+	{
+		std::cerr << "Image " << name << " is too big for a " << PAGE_SIZE << "x" << PAGE_SIZE << " atlas page" << std::endl;
+		return;
+	}
+
+	m_pending.push_back({ name, std::move(source), sourceRect, smooth });
+}
+
+// Shelf packing: images are placed left to right along a shelf as tall as the first (tallest) image on it.
+// When a shelf is full a new one starts below it, and when the page is full the rest go to the next page.
+// Sorting by height first keeps the wasted space above short images small.
+void TextureAtlas::packPage(std::vector<PendingImage*>& images, bool smooth)
+{
+	sf::Image page;
+	std::vector<PendingImage*> leftOver;
+	std::vector<std::pair<PendingImage*, sf::Vector2u>> placed;
+	unsigned int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+	for (auto image : images)
+	{
+		unsigned int w = image->rect.size.x + PADDING * 2;
+		unsigned int h = image->rect.size.y + PADDING * 2;
+
+		if (shelfX + w > PAGE_SIZE)
+		{
+			shelfY += shelfHeight;
+			shelfX = 0;
+			shelfHeight = 0;
+		}
+
+		if (shelfY + h > PAGE_SIZE)
+		{
+			leftOver.push_back(image);
+			continue;
+		}
+
+		placed.push_back({ image, { shelfX + PADDING, shelfY + PADDING } });
+		shelfX += w;
+		shelfHeight = std::max(shelfHeight, h);
+	}
+
+	size_t pageIndex = m_pages.size();
+	m_pages.emplace_back();
+	m_pageSmooth.push_back(smooth);
+
+	if (!m_upload && !m_keepPixels)
+	{
+		// Pages stay empty textures, the regions are all anyone will look at
+		for (auto& p : placed)
+		{
+			m_regions[p.first->name] = { pageIndex, sf::IntRect({ (int)p.second.x, (int)p.second.y }, p.first->rect.size) };
+		}
+
+		images.swap(leftOver);
+		return;
+	}
+
+	// Only keep as much of the page as was used
+	page.resize({ PAGE_SIZE, shelfY + shelfHeight }, sf::Color::Transparent);
+
+	for (auto& p : placed)
+	{
+		const sf::Image& image = *p.first->source;
+		sf::Vector2u pos = p.second;
+		sf::Vector2i origin = p.first->rect.position;
+		int w = p.first->rect.size.x, h = p.first->rect.size.y;
+
+		page.copy(image, pos, p.first->rect);
+
+		// Repeat the outermost pixels into the padding so smoothing at the edges doesn't blend in
+		// the neighbouring image
+		page.copy(image, { pos.x - PADDING, pos.y }, sf::IntRect(origin, { 1, h }));
+		page.copy(image, { pos.x + w, pos.y }, sf::IntRect({ origin.x + w - 1, origin.y }, { 1, h }));
+		page.copy(image, { pos.x, pos.y - PADDING }, sf::IntRect(origin, { w, 1 }));
+		page.copy(image, { pos.x, pos.y + h }, sf::IntRect({ origin.x, origin.y + h - 1 }, { w, 1 }));
+
+		m_regions[p.first->name] = { pageIndex, sf::IntRect({ (int)pos.x, (int)pos.y }, { w, h }) };
+	}
+
+	if (m_upload)
+	{
+		if (!m_pages.back().loadFromImage(page))
+		{
+			std::cerr << "Could not create texture atlas page " << pageIndex << std::endl;
+		}
+		m_pages.back().setSmooth(smooth);
+	}
+
+	if (m_keepPixels)
+	{
+		m_pageImages.push_back(std::move(page));
+	}
+
+	images.swap(leftOver);
+}
+
+void TextureAtlas::build()
+{
+	// Filtering is set per texture, so smoothed images get pages of their own. Tiles stay pixel exact.
+	for (bool smooth : { false, true })
+	{
+		std::vector<PendingImage*> images;
+		for (auto& p : m_pending)
+		{
+			if (p.smooth == smooth) { images.push_back(&p); }
+		}
+
+		std::stable_sort(images.begin(), images.end(), [](const PendingImage* a, const PendingImage* b)
+		{
+			return a->rect.size.y > b->rect.size.y;
+		});
+
+		while (!images.empty())
+		{
+			packPage(images, smooth);
+		}
+	}
+
+	// The pixels live on the GPU now
+	m_pending.clear();
+	m_pending.shrink_to_fit();
+}
+
+// Pages from an asset pack are already packed, they go straight to the GPU
+void TextureAtlas::addPage(const std::uint8_t* pixels, const sf::Vector2u& size, bool smooth)
+{
+	size_t pageIndex = m_pages.size();
+	m_pages.emplace_back();
+	m_pageSmooth.push_back(smooth);
+	if (!m_upload) { return; }
+
+	if (!m_pages.back().resize(size))
+	{
+		std::cerr << "Could not create texture atlas page " << pageIndex << std::endl;
+		return;
+	}
+	m_pages.back().update(pixels);
+	m_pages.back().setSmooth(smooth);
+}
+
+void TextureAtlas::addRegion(const std::string& name, const AtlasRegion& region)
+{
+	m_regions[name] = region;
+}
+
+bool TextureAtlas::hasRegion(const std::string& name) const
+{
+	return m_regions.find(name) != m_regions.end();
+}
+
+const AtlasRegion& TextureAtlas::getRegion(const std::string& name) const
+{
+	assert(hasRegion(name));
+	return m_regions.at(name);
+}
+
+const sf::Texture& TextureAtlas::getPage(size_t page) const
+{
+	assert(page < m_pages.size());
+	return m_pages[page];
+}
+
+size_t TextureAtlas::pageCount() const
+{
+	return m_pages.size();
+}
+
+bool TextureAtlas::isPageSmooth(size_t page) const
+{
+	assert(page < m_pageSmooth.size());
+	return m_pageSmooth[page];
+}
+
+const sf::Image& TextureAtlas::getPageImage(size_t page) const
+{
+	assert(m_keepPixels && page < m_pageImages.size());
+	return m_pageImages[page];
+}
+
+const std::unordered_map<std::string, AtlasRegion>& TextureAtlas::getRegions() const
+{
+	return m_regions;
+}
\ No newline at end of file
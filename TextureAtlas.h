@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Where an image ended up in the atlas
+struct AtlasRegion
+{
+	size_t			page = 0;
+	sf::IntRect		rect;
+};
+
+// Packs every image the game loads (tiles and animation strips) into a few large textures so
+// sprites from different images can be drawn together in one batch.
+// Images are queued with add() while assets load, then build() packs them all at once.
+class TextureAtlas
+{
+	// A region of a source image. Tiles from one tilesheet share the sheet instead of each getting a copy,
+	// their pixels are only copied once, straight into the page.
+	struct PendingImage
+	{
+		std::string							name;
+		std::shared_ptr<const sf::Image>	source;
+		sf::IntRect							rect;
+		bool								smooth;
+	};
+
+	std::vector<PendingImage>						m_pending;
+	std::deque<sf::Texture>							m_pages;		// Deque so references handed out stay valid
+	std::vector<sf::Image>							m_pageImages;	// Only filled with m_keepPixels
+	std::unordered_map<std::string, AtlasRegion>	m_regions;
+	std::vector<bool>								m_pageSmooth;	// Smoothed and pixel exact images never share a page
+	bool											m_upload = true;		// Off when nothing will be drawn, only regions are worked out
+	bool											m_keepPixels = false;	// For the asset packer, which writes the pages out instead of drawing them
+
+	void packPage(std::vector<PendingImage*>& images, bool smooth);
+
+public:
+	static constexpr unsigned int PAGE_SIZE = 4096;		// Supported by every GPU we care about
+	static constexpr unsigned int PADDING = 1;			// Border around each image, filled with its edge pixels
+
+	TextureAtlas() {}
+
+	void setUpload(bool upload);
+	void setKeepPixels(bool keep);
+	// Smooth images are filtered when scaled, the rest (pixel art tiles) are drawn pixel exact
+	void add(const std::string& name, sf::Image image, bool smooth = false);
+	void add(const std::string& name, std::shared_ptr<const sf::Image> source, const sf::IntRect& sourceRect, bool smooth = false);
+	void build();
+	void addPage(const std::uint8_t* pixels, const sf::Vector2u& size, bool smooth);
+	void addRegion(const std::string& name, const AtlasRegion& region);
+
+	bool hasRegion(const std::string& name) const;
+	const AtlasRegion& getRegion(const std::string& name) const;
+	const sf::Texture& getPage(size_t page) const;
+	size_t pageCount() const;
+	bool isPageSmooth(size_t page) const;
+	const sf::Image& getPageImage(size_t page) const;
+	const std::unordered_map<std::string, AtlasRegion>& getRegions() const;
+};
@@ -0,0 +1,155 @@
+#include "TileChunkCache.h"
+#include "Physics.h"
+
+#include <algorithm>
+#include <cmath>
+
+TileChunkCache::TileChunkCache(const Vec2& chunkSize) :
+	m_chunkSize(chunkSize)
+{
+
+}
+
+uint64_t TileChunkCache::key(int chunkX, int chunkY) const
+{
+	return ((uint64_t)(uint32_t)chunkX << 32) | (uint32_t)chunkY;
+}
+
+uint64_t TileChunkCache::key(const Vec2& pos) const
+{
+	return key((int)std::floor(pos.x / m_chunkSize.x), (int)std::floor(pos.y / m_chunkSize.y));
+}
+
+bool TileChunkCache::isBakeable(Entity e)
+{
+	if (!e.hasComponent<CAnimation>() || !e.hasComponent<CTransform>()) { return false; }
+
+	auto& animation = *e.getComponent<CAnimation>().animation;
+	return animation.getFrameCount() == 1 || animation.getSpeed() == 0;
+}
+
+void TileChunkCache::add(Entity e, uint8_t layer)
+{
+	Chunk& chunk = m_chunks[key(e.getComponent<CTransform>().pos)];
+	chunk.entities.push_back({ e, layer });
+	chunk.dirty = true;
+
+	// prepare looks this far past the view for chunks whose entities reach into it
+	if (e.hasComponent<CAnimation>())
+	{
+		sf::FloatRect bounds = Physics::GetDrawBounds(e);
+		m_overhang = std::max(m_overhang, std::max(bounds.size.x, bounds.size.y) / 2.0f);
+	}
+}
+
+void TileChunkCache::remove(Entity e, const Vec2& pos)
+{
+	auto it = m_chunks.find(key(pos));
+	if (it == m_chunks.end()) { return; }
+
+	auto& entities = it->second.entities;
+	entities.erase(std::remove_if(entities.begin(), entities.end(), [&](const BakedEntity& b) { return b.entity == e; }), entities.end());
+	it->second.dirty = true;
+}
+
+void TileChunkCache::bake(Chunk& chunk)
+{
+	m_scratch.clear();
+
+	bool first = true;
+	for (auto& b : chunk.entities)
+	{
+		if (!isBakeable(b.entity)) { continue; }
+
+		m_scratch.add(b.entity.getComponent<CAnimation>(), b.entity.getComponent<CTransform>(), b.layer);
+
+		sf::FloatRect bounds = Physics::GetDrawBounds(b.entity);
+		if (first)
+		{
+			chunk.bounds = bounds;
+			first = false;
+		}
+		else
+		{
+			float left = std::min(chunk.bounds.position.x, bounds.position.x);
+			float top = std::min(chunk.bounds.position.y, bounds.position.y);
+			float right = std::max(chunk.bounds.position.x + chunk.bounds.size.x, bounds.position.x + bounds.size.x);
+			float bottom = std::max(chunk.bounds.position.y + chunk.bounds.size.y, bounds.position.y + bounds.size.y);
+			chunk.bounds = sf::FloatRect({ left, top }, { right - left, bottom - top });
+		}
+	}
+
+	// Upload the vertices once, they stay on the GPU until the chunk changes again
+	const bool useBuffers = sf::VertexBuffer::isAvailable();
+	chunk.layers.assign(m_scratch.layerCount(), {});
+	for (uint8_t layer = 0; layer < chunk.layers.size(); ++layer)
+	{
+		// Reserved up front so the buffers are never copied when the vector grows
+		auto& batches = chunk.layers[layer];
+		batches.reserve(m_scratch.batchCount(layer));
+
+		for (size_t i = 0; i < m_scratch.batchCount(layer); ++i)
+		{
+			const sf::VertexArray& vertices = m_scratch.batchVertices(layer, i);
+			BakedBatch& baked = batches.emplace_back();
+			baked.texture = &m_scratch.batchTexture(layer, i);
+
+			if (!useBuffers || !baked.buffer.create(vertices.getVertexCount()) || !baked.buffer.update(&vertices[0]))
+			{
+				baked.vertices = vertices;
+			}
+		}
+	}
+
+	if (first) { chunk.bounds = sf::FloatRect(); }
+	chunk.dirty = false;
+}
+
+void TileChunkCache::prepare(const sf::FloatRect& view)
+{
+	m_visible.clear();
+
+	int firstX = (int)std::floor((view.position.x - m_overhang) / m_chunkSize.x);
+	int lastX = (int)std::floor((view.position.x + view.size.x + m_overhang) / m_chunkSize.x);
+	int firstY = (int)std::floor((view.position.y - m_overhang) / m_chunkSize.y);
+	int lastY = (int)std::floor((view.position.y + view.size.y + m_overhang) / m_chunkSize.y);
+
+	for (int x = firstX; x <= lastX; ++x)
+	{
+		for (int y = firstY; y <= lastY; ++y)
+		{
+			auto it = m_chunks.find(key(x, y));
+			if (it == m_chunks.end()) { continue; }
+
+			Chunk& chunk = it->second;
+			if (chunk.dirty) { bake(chunk); }
+			if (!chunk.layers.empty() && chunk.bounds.findIntersection(view))
+			{
+				m_visible.push_back(&chunk);
+			}
+		}
+	}
+}
+
+size_t TileChunkCache::draw(sf::RenderTarget& target, uint8_t layer) const
+{
+	size_t drawCalls = 0;
+	for (const Chunk* chunk : m_visible)
+	{
+		if (layer >= chunk->layers.size()) { continue; }
+
+		for (auto& baked : chunk->layers[layer])
+		{
+			sf::RenderStates states(baked.texture);
+			if (baked.vertices.getVertexCount() > 0) { target.draw(baked.vertices, states); }
+			else { target.draw(baked.buffer, states); }
+			drawCalls++;
+		}
+	}
+	return drawCalls;
+}
+
+size_t TileChunkCache::chunkCount() const
+{
+	return m_chunks.size();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Entity.h"
+#include "SpriteBatch.h"
+
+#include <SFML/Graphics.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Static scenery baked into fixed-size chunks of the world. Each chunk uploads the vertices for its
+// entities into static vertex buffers, one per layer and texture, and only rebuilds them when something
+// in the chunk changes. Drawing the level background is then a few draw calls per visible chunk with
+// no vertices sent to the GPU, instead of re-emitting every tile.
+//
+// Only single frame animations are baked. Entities that start animating (e.g. a destroyable tile
+// playing its death animation) drop out of their chunk on the next rebuild and must be drawn normally.
+class TileChunkCache
+{
+	struct BakedEntity
+	{
+		Entity		entity;
+		uint8_t		layer;
+	};
+
+	struct BakedBatch
+	{
+		const sf::Texture*		texture = nullptr;
+		sf::VertexBuffer		buffer = sf::VertexBuffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static);
+		sf::VertexArray			vertices;			// Only used where the GPU has no vertex buffers
+	};
+
+	struct Chunk
+	{
+		std::vector<BakedEntity>				entities;
+		std::vector<std::vector<BakedBatch>>	layers;
+		sf::FloatRect							bounds;			// Union of the drawn bounds of the baked entities
+		bool									dirty = true;
+	};
+
+	std::unordered_map<uint64_t, Chunk>	m_chunks;
+	Vec2								m_chunkSize = { 1024, 1024 };
+	float								m_overhang = 0;			// Furthest any entity is drawn outside its chunk
+	SpriteBatch							m_scratch;				// Builds the vertices a chunk is baked from
+	std::vector<Chunk*>					m_visible;				// Chunks overlapping the view, set by prepare
+
+	uint64_t key(int chunkX, int chunkY) const;
+	uint64_t key(const Vec2& pos) const;
+	void bake(Chunk& chunk);
+
+public:
+	TileChunkCache() {}
+	TileChunkCache(const Vec2& chunkSize);
+
+	static bool isBakeable(Entity e);
+
+	// Entities are placed in the chunk containing their position
+	void add(Entity e, uint8_t layer);
+	void remove(Entity e, const Vec2& pos);
+
+	// Call once a frame before drawing: finds the chunks overlapping view and rebuilds any that changed
+	void prepare(const sf::FloatRect& view);
+
+	// Draws one layer of the chunks found by prepare. Returns the number of draw calls issued.
+	size_t draw(sf::RenderTarget& target, uint8_t layer) const;
+	size_t chunkCount() const;
+};
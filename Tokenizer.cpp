@@ -0,0 +1,152 @@
+#include "Tokenizer.h"
+
+#include <charconv>
+
+Tokenizer::Tokenizer(std::string_view text) :
+	m_text(text)
+{
+}
+
+void Tokenizer::skipWhitespace(bool stopAtNewline)
+{
+	while (m_pos < m_text.size())
+	{
+		char c = m_text[m_pos];
+		if (c == '\n')
+		{
+			if (stopAtNewline) { return; }
+			m_line++;
+			m_lineStart = m_pos + 1;
+		}
+		else if (c != ' ' && c != '\t' && c != '\r' && c != '\f' && c != '\v')
+		{
+			return;
+		}
+		m_pos++;
+	}
+}
+
+// Next token anywhere after the current position, false at the end of the text
+bool Tokenizer::next(std::string_view& token)
+{
+	skipWhitespace(false);
+	if (m_pos >= m_text.size())
+	{
+		m_failed = true;
+		return false;
+	}
+
+	m_tokenLine = m_line;
+	m_tokenColumn = m_pos - m_lineStart + 1;
+
+	size_t start = m_pos;
+	while (m_pos < m_text.size())
+	{
+		char c = m_text[m_pos];
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v') { break; }
+		m_pos++;
+	}
+
+	token = m_text.substr(start, m_pos - start);
+	return true;
+}
+
+// Next token on the current line, false (without failing) once the line has run out
+bool Tokenizer::nextOnLine(std::string_view& token)
+{
+	skipWhitespace(true);
+	if (m_pos >= m_text.size() || m_text[m_pos] == '\n') { return false; }
+	return next(token);
+}
+
+// Moves to the start of the next line, dropping whatever is left of this one
+void Tokenizer::skipLine()
+{
+	while (m_pos < m_text.size() && m_text[m_pos] != '\n') { m_pos++; }
+	if (m_pos < m_text.size())
+	{
+		m_pos++;
+		m_line++;
+		m_lineStart = m_pos;
+	}
+}
+
+bool Tokenizer::atEnd()
+{
+	skipWhitespace(false);
+	return m_pos >= m_text.size();
+}
+
+Tokenizer& Tokenizer::operator >> (std::string& value)
+{
+	std::string_view token;
+	if (next(token)) { value.assign(token.data(), token.size()); }
+	return *this;
+}
+
+Tokenizer& Tokenizer::operator >> (int& value)
+{
+	std::string_view token;
+	if (next(token) && !toNumber(token, value)) { m_failed = true; }
+	return *this;
+}
+
+Tokenizer& Tokenizer::operator >> (size_t& value)
+{
+	std::string_view token;
+	if (next(token) && !toNumber(token, value)) { m_failed = true; }
+	return *this;
+}
+
+Tokenizer& Tokenizer::operator >> (float& value)
+{
+	std::string_view token;
+	if (next(token) && !toNumber(token, value)) { m_failed = true; }
+	return *this;
+}
+
+// False once a read has run off the end or a number didn't parse, like a stream's fail state
+Tokenizer::operator bool() const
+{
+	return !m_failed;
+}
+
+void Tokenizer::clearError()
+{
+	m_failed = false;
+}
+
+size_t Tokenizer::line() const
+{
+	return m_tokenLine;
+}
+
+size_t Tokenizer::column() const
+{
+	return m_tokenColumn;
+}
+
+// The whole token has to be the number, "12abc" is not 12
+bool Tokenizer::toNumber(std::string_view token, int& value)
+{
+	const char* end = token.data() + token.size();
+	auto result = std::from_chars(token.data(), end, value);
+	return result.ec == std::errc() && result.ptr == end;
+}
+
+bool Tokenizer::toNumber(std::string_view token, size_t& value)
+{
+	const char* end = token.data() + token.size();
+	auto result = std::from_chars(token.data(), end, value);
+	return result.ec == std::errc() && result.ptr == end;
+}
+
+bool Tokenizer::toNumber(std::string_view token, float& value)
+{
+	// from_chars doesn't take the leading + that streams do
+	if (!token.empty() && token[0] == '+') { token.remove_prefix(1); }
+
+	const char* end = token.data() + token.size();
+	auto result = std::from_chars(token.data(), end, value);
+	return result.ec == std::errc() && result.ptr == end;
+}
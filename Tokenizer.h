@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Splits text (usually a MemoryMapping's view) into whitespace separated tokens in place - tokens are
+// string_views into the text, nothing is copied until a caller asks for a std::string.
+// Reads like an std::istream, so "fin >> name >> x >> y" parsers work unchanged, and keeps track of
+// the line and column of the last token for error messages.
+class Tokenizer
+{
+	std::string_view	m_text;
+	size_t				m_pos = 0;
+	size_t				m_line = 1;				// Of m_pos
+	size_t				m_lineStart = 0;
+	size_t				m_tokenLine = 0;		// Where the last token read started
+	size_t				m_tokenColumn = 0;
+	bool				m_failed = false;
+
+	void skipWhitespace(bool stopAtNewline);
+
+public:
+	Tokenizer(std::string_view text);
+
+	bool next(std::string_view& token);
+	bool nextOnLine(std::string_view& token);
+	void skipLine();
+	bool atEnd();
+
+	Tokenizer& operator >> (std::string& value);
+	Tokenizer& operator >> (int& value);
+	Tokenizer& operator >> (size_t& value);
+	Tokenizer& operator >> (float& value);
+
+	explicit operator bool() const;
+	void clearError();
+
+	size_t line() const;
+	size_t column() const;
+
+	static bool toNumber(std::string_view token, int& value);
+	static bool toNumber(std::string_view token, size_t& value);
+	static bool toNumber(std::string_view token, float& value);
+};
@@ -0,0 +1,212 @@
+// AssetPacker.cpp : Builds the binary asset pack the game can load instead of assets.txt.
+//
+// Usage (from the game's working directory, since assets.txt paths are relative to it):
+//		AssetPacker [assets.txt] [output.pack]			defaults to assets/assets.txt and assets/assets.pack
+//
+// The assets are loaded with the game's own Assets class, with the atlas kept on the CPU instead of
+// uploaded, so the pack holds exactly what the game would have built at startup. See AssetPack.h for the layout.
+
+#include "Assets.h"
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Collects the records for each section, then lays them out and writes the file in one go.
+// Records are written as they are in memory, which is the pack's little endian layout on every
+// machine the game builds for.
+class PackWriter
+{
+	std::string									m_strings;
+	std::unordered_map<std::string, PackString>	m_stringOffsets;
+	std::vector<PackPage>						m_pages;
+	std::vector<char>							m_pixels;
+	std::vector<PackRegion>						m_regions;
+	std::vector<PackAnimation>					m_animations;
+	std::vector<PackFile>						m_files;
+	std::vector<char>							m_data;
+
+	template <typename T>
+	static std::vector<char> recordBytes(const std::vector<T>& records)
+	{
+		const char* bytes = (const char*)records.data();
+		return std::vector<char>(bytes, bytes + records.size() * sizeof(T));
+	}
+
+public:
+
+	PackString addString(const std::string& str)
+	{
+		auto it = m_stringOffsets.find(str);
+		if (it != m_stringOffsets.end()) { return it->second; }
+
+		PackString packString = { (uint32_t)m_strings.size(), (uint32_t)str.size() };
+		m_strings += str;
+		m_stringOffsets[str] = packString;
+		return packString;
+	}
+
+	void addPage(const sf::Image& image, bool smooth)
+	{
+		const size_t bytes = (size_t)image.getSize().x * image.getSize().y * 4;
+		m_pages.push_back({ image.getSize().x, image.getSize().y, smooth ? 1u : 0u, 0, (uint64_t)m_pixels.size() });
+
+		const char* pixels = (const char*)image.getPixelsPtr();
+		m_pixels.insert(m_pixels.end(), pixels, pixels + bytes);
+	}
+
+	void addRegion(const std::string& name, const AtlasRegion& region)
+	{
+		m_regions.push_back({ addString(name), (uint32_t)region.page, region.rect.position.x, region.rect.position.y, region.rect.size.x, region.rect.size.y });
+	}
+
+	void addAnimation(const Assets::AnimationDefinition& animation)
+	{
+		m_animations.push_back({ addString(animation.name), addString(animation.textureName), (uint32_t)animation.frameCount, (uint32_t)animation.speed });
+	}
+
+	void addFile(const std::string& name, PackFileKind kind, const std::vector<char>& bytes)
+	{
+		m_files.push_back({ addString(name), (uint32_t)kind, 0, (uint64_t)m_data.size(), (uint64_t)bytes.size() });
+		m_data.insert(m_data.end(), bytes.begin(), bytes.end());
+	}
+
+	size_t regionCount() const { return m_regions.size(); }
+
+	bool write(const std::string& path) const
+	{
+		struct SectionData
+		{
+			PackSectionId		id;
+			uint32_t			count;
+			std::vector<char>	bytes;
+		};
+
+		const std::vector<SectionData> sections =
+		{
+			{ PackSectionId::Strings,		0,								std::vector<char>(m_strings.begin(), m_strings.end()) },
+			{ PackSectionId::Pages,			(uint32_t)m_pages.size(),		recordBytes(m_pages) },
+			{ PackSectionId::Pixels,		0,								m_pixels },
+			{ PackSectionId::Regions,		(uint32_t)m_regions.size(),		recordBytes(m_regions) },
+			{ PackSectionId::Animations,	(uint32_t)m_animations.size(),	recordBytes(m_animations) },
+			{ PackSectionId::Files,			(uint32_t)m_files.size(),		recordBytes(m_files) },
+			{ PackSectionId::Data,			0,								m_data }
+		};
+
+		PackHeader header = {};
+		std::memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+		header.version = ASSET_PACK_VERSION;
+		header.sectionCount = (uint32_t)sections.size();
+
+		// Sections start on 8 byte boundaries, after the header and table of contents
+		std::vector<PackSection> toc;
+		uint64_t offset = sizeof(PackHeader) + sections.size() * sizeof(PackSection);
+		for (auto& section : sections)
+		{
+			offset = (offset + 7) & ~(uint64_t)7;
+			toc.push_back({ (uint32_t)section.id, section.count, offset, (uint64_t)section.bytes.size() });
+			offset += section.bytes.size();
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cerr << "Could not open " << path << " to write the pack to" << std::endl;
+			return false;
+		}
+
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)toc.data(), toc.size() * sizeof(PackSection));
+		for (size_t i = 0; i < sections.size(); i++)
+		{
+			static const char padding[8] = {};
+			file.write(padding, toc[i].offset - (uint64_t)file.tellp());
+			file.write(sections[i].bytes.data(), sections[i].bytes.size());
+		}
+
+		return file.good();
+	}
+};
+
+static bool readWholeFile(const std::string& path, std::vector<char>& bytes)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) { return false; }
+
+	bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string inputPath = argc > 1 ? argv[1] : "assets/assets.txt";
+	std::string outputPath = argc > 2 ? argv[2] : "assets/assets.pack";
+	if (argc > 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " [assets.txt] [output.pack]\n";
+		return 1;
+	}
+
+	// Nothing is drawn, the finished atlas pages stay in memory for the pack instead
+	Assets assets;
+	assets.setUploadTextures(false);
+	assets.setKeepAtlasPixels(true);
+	if (!assets.loadFromFile(inputPath))
+	{
+		std::cerr << "Not packing " << inputPath << " until the errors above are fixed" << std::endl;
+		return 1;
+	}
+
+	PackWriter writer;
+	const TextureAtlas& atlas = assets.getAtlas();
+	for (size_t i = 0; i < atlas.pageCount(); i++)
+	{
+		writer.addPage(atlas.getPageImage(i), atlas.isPageSmooth(i));
+	}
+
+	// Sorted so packing the same assets always gives the same file
+	std::vector<std::pair<std::string, AtlasRegion>> regions(atlas.getRegions().begin(), atlas.getRegions().end());
+	std::sort(regions.begin(), regions.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	for (auto& region : regions)
+	{
+		writer.addRegion(region.first, region.second);
+	}
+
+	for (auto& animation : assets.getAnimationDefinitions())
+	{
+		writer.addAnimation(animation);
+	}
+
+	for (auto& file : assets.getFiles())
+	{
+		std::vector<char> bytes;
+		switch (file.kind)
+		{
+		case Assets::AssetFile::Kind::Font:
+		case Assets::AssetFile::Kind::Sound:
+			if (!readWholeFile(file.path, bytes))
+			{
+				std::cerr << "Could not read " << file.path << std::endl;
+				return 1;
+			}
+			writer.addFile(file.name, file.kind == Assets::AssetFile::Kind::Font ? PackFileKind::Font : PackFileKind::Sound, bytes);
+			break;
+		case Assets::AssetFile::Kind::Music:
+			bytes.assign(file.path.begin(), file.path.end());
+			writer.addFile(file.name, PackFileKind::Music, bytes);
+			break;
+		}
+	}
+
+	if (!writer.write(outputPath)) { return 1; }
+
+	std::cout << "Packed " << atlas.pageCount() << " atlas page(s), " << writer.regionCount() << " regions, "
+		<< assets.getAnimationDefinitions().size() << " animations and " << assets.getFiles().size() << " files into " << outputPath << "\n";
+	return 0;
+}